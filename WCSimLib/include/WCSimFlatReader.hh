@@ -0,0 +1,159 @@
+#ifndef WCSim_FlatReader
+#define WCSim_FlatReader
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+//    WCSimFlatReader                                                   //
+//                                                                      //
+//  Column-wise (structure of arrays) view of the triggers of a WCSim   //
+//  event tree. Every entry is unpacked once into flat columns that     //
+//  are reused between entries; the columns of one trigger are spans    //
+//  into them, so consumers never touch the WCSimRoot* objects.         //
+//  This is a convenience view, not a faster reader: the whole event    //
+//  is still streamed into WCSimRoot* objects and then copied, so it    //
+//  is slower than reading the objects directly. Only the enabled       //
+//  column groups are copied.                                           //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "TObject.h"
+
+class TFile;
+class TTree;
+class WCSimRootEvent;
+class WCSimRootCapacityHints;
+
+// Read-only view of a contiguous range of a column
+template <typename T> class WCSimFlatSpan {
+public:
+  WCSimFlatSpan() : fData(0), fSize(0) {}
+  WCSimFlatSpan(const T * data, size_t size) : fData(data), fSize(size) {}
+
+  const T * begin()              const {return fData;}
+  const T * end()                const {return fData + fSize;}
+  const T * data()               const {return fData;}
+  size_t    size()               const {return fSize;}
+  bool      empty()              const {return fSize == 0;}
+  const T & operator[](size_t i) const {return fData[i];}
+
+private:
+  const T * fData;
+  size_t    fSize;
+};
+
+class WCSimFlatReader {
+public:
+  // Column groups that are unpacked, the getters of the other groups return empty columns.
+  // Photon IDs and track start positions also need their digits or tracks
+  enum Columns_t {
+    kDigits         = 1 << 0,
+    kDigitPhotonIds = 1 << 1,
+    kTracks         = 1 << 2,
+    kTrackStart     = 1 << 3,
+    kPhotons        = 1 << 4,
+    kDefaultColumns = kDigits | kTracks,
+    kAllColumns     = kDigits | kDigitPhotonIds | kTracks | kTrackStart | kPhotons
+  };
+
+  // Reads the given event branch of the tree (wcsimT: "wcsimrootevent", "wcsimrootevent_OD", ...).
+  // Only this branch is enabled and cached, the tree is not owned
+  WCSimFlatReader(TTree * tree, const char * branch = "wcsimrootevent", Long64_t cache_size = 32*1024*1024);
+  // Opens the file and reads its wcsimT tree, the file is owned by the reader.
+  // Readers of the same file in different threads each open their own TFile, see WCSimRootEvent.hh
+  WCSimFlatReader(const char * filename, const char * branch = "wcsimrootevent", Long64_t cache_size = 32*1024*1024);
+  virtual ~WCSimFlatReader();
+
+  bool      IsValid()    const {return fEvent != 0;}
+  Long64_t  GetEntries() const;
+  // Unpack all triggers of one entry into the columns, returns false if the entry could not be read
+  bool      GetEntry(Long64_t entry);
+  Long64_t  GetCurrentEntry() const {return fEntry;}
+  // Column groups unpacked by the next GetEntry(), default kDigits | kTracks
+  void      SetColumns(UInt_t columns) {fColumns = columns;}
+  UInt_t    GetColumns() const {return fColumns;}
+
+  Int_t     GetNTriggers()                  const {return fTriggerDate.size();}
+  int64_t   GetTriggerDate(Int_t trigger)   const {return fTriggerDate[trigger];}
+  Int_t     GetTriggerType(Int_t trigger)   const {return fTriggerType[trigger];}
+
+  // Digits of a trigger (empty slots of the TClonesArray are skipped)
+  Int_t     GetNDigits(Int_t trigger)       const {return fDigitBegin[trigger+1] - fDigitBegin[trigger];}
+  WCSimFlatSpan<Float_t> GetDigitQ(Int_t trigger)    const {return Span(fDigitQ, fDigitBegin, trigger);}
+  WCSimFlatSpan<Double_t> GetDigitT(Int_t trigger)   const {return Span(fDigitT, fDigitBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetDigitTube(Int_t trigger) const {return Span(fDigitTube, fDigitBegin, trigger);}
+  // Photon IDs of a digit (index of the digit within its trigger), they refer to the photons of the first trigger
+  WCSimFlatSpan<Int_t>   GetDigitPhotonIds(Int_t trigger, Int_t digit) const {
+    if (!(fUnpacked & kDigitPhotonIds)) return WCSimFlatSpan<Int_t>();
+    Int_t i = fDigitBegin[trigger] + digit;
+    return WCSimFlatSpan<Int_t>(fPhotonIds.data() + fPhotonIdBegin[i], fPhotonIdBegin[i+1] - fPhotonIdBegin[i]);
+  }
+
+  // Tracks of a trigger (empty slots of the TClonesArray are skipped)
+  Int_t     GetNTracks(Int_t trigger)       const {return fTrackBegin[trigger+1] - fTrackBegin[trigger];}
+  WCSimFlatSpan<Int_t>   GetTrackPdg(Int_t trigger)        const {return Span(fTrackPdg, fTrackBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetTrackFlag(Int_t trigger)       const {return Span(fTrackFlag, fTrackBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetTrackId(Int_t trigger)         const {return Span(fTrackId, fTrackBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetTrackParentId(Int_t trigger)   const {return Span(fTrackParentId, fTrackBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetTrackParentType(Int_t trigger) const {return Span(fTrackParentType, fTrackBegin, trigger);}
+  WCSimFlatSpan<Float_t> GetTrackE(Int_t trigger)          const {return Span(fTrackE, fTrackBegin, trigger);}
+  WCSimFlatSpan<Double_t> GetTrackTime(Int_t trigger)      const {return Span(fTrackTime, fTrackBegin, trigger);}
+  // Start position of every track of a trigger, x, y, z per track [cm]
+  WCSimFlatSpan<Float_t> GetTrackStart(Int_t trigger) const {
+    if (!(fUnpacked & kTrackStart)) return WCSimFlatSpan<Float_t>();
+    return WCSimFlatSpan<Float_t>(fTrackStart.data() + 3*fTrackBegin[trigger], 3*GetNTracks(trigger));
+  }
+
+  // True photons (CherenkovHitTimes) of a trigger
+  Int_t     GetNPhotons(Int_t trigger)      const {return fPhotonBegin[trigger+1] - fPhotonBegin[trigger];}
+  WCSimFlatSpan<Double_t> GetPhotonTrueTime(Int_t trigger) const {return Span(fPhotonTrueTime, fPhotonBegin, trigger);}
+  WCSimFlatSpan<Int_t>   GetPhotonParentId(Int_t trigger) const {return Span(fPhotonParentId, fPhotonBegin, trigger);}
+
+  // The event object of the current entry, for the variables without column
+  const WCSimRootEvent * GetEvent() const {return fEvent;}
+  // High-water marks of the trigger arrays of all entries read so far (statistics only, the streamed triggers are
+  // not resized). The capacities follow the high-water marks and can be copied to the hints of a WCSimRootEvent
+  // that writes the reprocessed events
+  const WCSimRootCapacityHints * GetCapacityHints() const {return fCapacityHints;}
+
+private:
+  template <typename T> static WCSimFlatSpan<T> Span(const std::vector<T> & column, const std::vector<Int_t> & begin, Int_t trigger) {
+    return WCSimFlatSpan<T>(column.data() + begin[trigger], begin[trigger+1] - begin[trigger]);
+  }
+  void Init(const char * branch, Long64_t cache_size);
+  void Unpack();
+
+  TFile          * fFile;                                        // owned, only with the filename constructor
+  TTree          * fTree;
+  WCSimRootEvent * fEvent;
+  WCSimRootCapacityHints * fCapacityHints;                       // owned
+  UInt_t           fColumns;                                     // Columns_t
+  UInt_t           fUnpacked;                                    // column groups of the current entry
+  Long64_t         fEntry;
+
+  // per trigger
+  std::vector<int64_t> fTriggerDate;
+  std::vector<Int_t>   fTriggerType;
+  std::vector<Int_t>   fDigitBegin, fTrackBegin, fPhotonBegin;   // first row of every trigger, one more entry than triggers
+
+  // digits
+  std::vector<Float_t> fDigitQ;
+  std::vector<Double_t> fDigitT;
+  std::vector<Int_t>   fDigitTube;
+  std::vector<Int_t>   fPhotonIdBegin;                           // first photon ID of every digit, one more entry than digits
+  std::vector<Int_t>   fPhotonIds;
+
+  // tracks
+  std::vector<Int_t>   fTrackPdg, fTrackFlag, fTrackId, fTrackParentId, fTrackParentType;
+  std::vector<Float_t> fTrackE, fTrackStart;
+  std::vector<Double_t> fTrackTime;
+
+  // true photons
+  std::vector<Double_t> fPhotonTrueTime;
+  std::vector<Int_t>   fPhotonParentId;
+};
+
+#endif
@@ -167,7 +167,7 @@ public:
   Float_t     GetQ() const { return fQ;}
   Double_t     GetT() const { return fT;}
   Int_t       GetTubeId() const { return fTubeId;}
-  std::vector<int> GetPhotonIds() const { return fPhotonIds; }
+  const std::vector<int>& GetPhotonIds() const { return fPhotonIds; }
 
   ClassDef(WCSimRootCherenkovDigiHit,2)  
 };
@@ -230,15 +230,67 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
+class WCSimRootTrigger;
+
+// Initial capacities of the TClonesArrays of the triggers created by one WCSimRootEvent with Initialize()/AddSubEvent(),
+// i.e. of events that are filled and written. Triggers report the number of used slots of their arrays when they are
+// cleared or deleted. In adaptive mode the capacity of new triggers follows the high-water mark plus some headroom,
+// and arrays that are much larger than that are shrunk when their trigger is cleared. Triggers read from a file are
+// sized by the streamer, for them the hints only collect statistics (Observe(trigger)). Not shared between events.
+class WCSimRootCapacityHints {
+public:
+  enum Array_t { kTracks = 0, kCherenkovHits, kCherenkovHitTimes, kCherenkovDigiHits, kNArrays };
+  static const Int_t kDefaultCapacity = 10000;
+
+  WCSimRootCapacityHints(Int_t capacity = kDefaultCapacity, bool adaptive = true);
+
+  void          SetCapacity(Int_t array, Int_t capacity);
+  void          SetCapacity(Int_t capacity) {for (Int_t i = 0; i < kNArrays; i++) SetCapacity(i, capacity);}
+  void          SetAdaptive(bool adaptive) {fAdaptive = adaptive;}
+  void          SetMinCapacity(Int_t capacity) {fMinCapacity = (capacity > 0) ? capacity : 1;}
+  void          ResetStatistics();
+
+  // Record the used slots of one array of a trigger that started with the given capacity and now has the given size.
+  // Returns the capacity the array should be shrunk to, 0 to keep it
+  Int_t         Observe(Int_t array, Int_t used, Int_t initial, Int_t allocated);
+  // Record the used slots of a trigger that was not created with these hints (e.g. read from a file),
+  // in adaptive mode the capacities follow the high-water marks
+  void          Observe(const WCSimRootTrigger * trigger);
+
+  Int_t         GetCapacity(Int_t array)      const {return fCapacity[array];}
+  bool          IsAdaptive()                  const {return fAdaptive;}
+  Int_t         GetHighWaterMark(Int_t array) const {return fHighWaterMark[array];}
+  Long64_t      GetNObserved(Int_t array)     const {return fNObserved[array];}
+  Long64_t      GetNOverflows(Int_t array)    const {return fNOverflows[array];}  // arrays that outgrew their initial capacity
+  Long64_t      GetNShrunk(Int_t array)       const {return fNShrunk[array];}
+  static const char * GetArrayName(Int_t array);
+  void          Print() const;
+
+private:
+  Int_t    AdaptiveCapacity(Int_t array) const;
+
+  Int_t    fCapacity[kNArrays];
+  Int_t    fHighWaterMark[kNArrays];
+  Long64_t fNObserved[kNArrays];
+  Long64_t fNOverflows[kNArrays];
+  Long64_t fNShrunk[kNArrays];
+  Int_t    fMinCapacity;
+  bool     fAdaptive;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 class WCSimRootTrigger : public TObject {
 
 private:
   WCSimRootEventHeader    fEvtHdr;  // The header
-  // See jhfNtuple.h for the meaning of these data members:
-  Int_t                fMode[MAX_N_VERTICES];
+  // See jhfNtuple.h for the meaning of these data members.
+  // Only the used vertices are stored (at least one), files written with the
+  // fixed MAX_N_VERTICES arrays (class version < 4) are converted on reading
+  std::vector<Int_t>   fMode;
   Int_t                fNvtxs;
-  Int_t                fVtxsvol[MAX_N_VERTICES];
-  Float_t              fVtxs[MAX_N_VERTICES][4];
+  std::vector<Int_t>   fVtxsvol;
+  std::vector<Float_t> fVtxs;               // x, y, z, t of every vertex
   Int_t                fVecRecNumber;       // "info event" number in inputvectorfile 
   Int_t                fJmu;
   Int_t                fJp;
@@ -269,14 +321,25 @@ private:
 
   bool IsZombie;
 
+  WCSimRootCapacityHints *fCapacityHints;  //! capacities of the arrays, owned by the WCSimRootEvent (0: defaults, not adapted)
+  Int_t fInitialCapacity[WCSimRootCapacityHints::kNArrays];  //! capacity of the arrays after Initialize/Clear
+
+  void ObserveCapacity(Int_t shrink[WCSimRootCapacityHints::kNArrays]);
+  void ResizeVertices(Int_t n) {
+    if (n > (Int_t)fMode.size())    fMode.resize(n, 0);
+    if (n > (Int_t)fVtxsvol.size()) fVtxsvol.resize(n, 0);
+    if (4*n > (Int_t)fVtxs.size())  fVtxs.resize(4*n, 0);
+  }
+  Float_t VtxAt(Int_t n, Int_t i) const {return (n >= 0 && 4*n+i < (Int_t)fVtxs.size()) ? fVtxs[4*n+i] : 0;}
+
 public:
   WCSimRootTrigger();
-  WCSimRootTrigger(int, int);
+  WCSimRootTrigger(int, int, WCSimRootCapacityHints * hints = 0);
   virtual ~WCSimRootTrigger();
   WCSimRootTrigger & operator=(const WCSimRootTrigger & in);
   bool CompareAllVariables(const WCSimRootTrigger * c, bool deep_comparison = false) const;
   
-  void Initialize();
+  void Initialize(WCSimRootCapacityHints * hints = 0);
 
   void          Clear(Option_t *option ="");
   static void   Reset(Option_t *option ="");
@@ -284,13 +347,13 @@ public:
   void          SetHeader(Int_t i, Int_t run, int64_t date,Int_t subevtn=1);
   void          SetTriggerInfo(TriggerType_t trigger_type, std::vector<Float_t> trigger_info);
   bool          IsASubEvent() {  return (fEvtHdr.GetSubEvtNumber()>=1); }
-  void          SetMode(Int_t i) {fMode[0] = i;}
-  void          SetMode(Int_t index, Int_t value){fMode[index]=value;}
-  void          SetNvtxs(Int_t i) {fNvtxs = i;}
-  void          SetVtxvol(Int_t i) {fVtxsvol[0] = i;}
-  void          SetVtxsvol(Int_t i, Int_t v) {fVtxsvol[i] = v;}
+  void          SetMode(Int_t i) {SetMode(0,i);}
+  void          SetMode(Int_t index, Int_t value){ResizeVertices(index+1); fMode[index]=value;}
+  void          SetNvtxs(Int_t i) {fNvtxs = i; ResizeVertices(i);}
+  void          SetVtxvol(Int_t i) {SetVtxsvol(0,i);}
+  void          SetVtxsvol(Int_t i, Int_t v) {ResizeVertices(i+1); fVtxsvol[i] = v;}
   void          SetVtx(Int_t i, Double_t f) {SetVtxs(0,i,f);}
-  void          SetVtxs(Int_t n, Int_t i, Double_t f) {fVtxs[n][i]= ( (i<4) ? f : 0);}
+  void          SetVtxs(Int_t n, Int_t i, Double_t f) {if (i<0 || i>=4) return; ResizeVertices(n+1); fVtxs[4*n+i] = f;}
   void          SetVecRecNumber(Int_t i) {fVecRecNumber = i;}
   void          SetJmu(Int_t i) {fJmu = i;}
   void          SetJp(Int_t i) {fJp = i;}
@@ -307,15 +370,15 @@ public:
   const WCSimRootEventHeader * GetHeader()     const {return &fEvtHdr; }
   WCSimRootPi0       *GetPi0Info()                 {return &fPi0; }
   const WCSimRootPi0         * GetPi0Info()    const {return &fPi0; }
-  Int_t               GetMode()               const {return fMode[0];}
-  Int_t               GetMode(Int_t index)    const {return fMode[index];}
-  Int_t               GetVtxvol()             const {return fVtxsvol[0];}
-  Float_t             GetVtx(Int_t i=0)             {return (i<3) ? fVtxs[0][i]: 0;}
-  TVector3            GetVertex(Int_t i)       {return TVector3(fVtxs[i][0],fVtxs[i][1],fVtxs[i][2]);}
+  Int_t               GetMode()               const {return GetMode(0);}
+  Int_t               GetMode(Int_t index)    const {return (index >= 0 && index < (Int_t)fMode.size()) ? fMode[index] : 0;}
+  Int_t               GetVtxvol()             const {return GetVtxsvol(0);}
+  Float_t             GetVtx(Int_t i=0)             {return (i<3) ? VtxAt(0,i): 0;}
+  TVector3            GetVertex(Int_t i)       {return TVector3(VtxAt(i,0),VtxAt(i,1),VtxAt(i,2));}
   Int_t               GetNvtxs()             const {return fNvtxs;}
-  Int_t               GetVtxsvol(Int_t i)             const {return fVtxsvol[i];}
-  Float_t             GetVtxs(Int_t n, Int_t i=0)     const {return (i<3) ? fVtxs[n][i]: 0;}
-  TLorentzVector      Get4Vertex(Int_t i)   {return TLorentzVector(fVtxs[i][0],fVtxs[i][1],fVtxs[i][2],fVtxs[i][3]);}
+  Int_t               GetVtxsvol(Int_t i)             const {return (i >= 0 && i < (Int_t)fVtxsvol.size()) ? fVtxsvol[i] : 0;}
+  Float_t             GetVtxs(Int_t n, Int_t i=0)     const {return (i<3) ? VtxAt(n,i): 0;}
+  TLorentzVector      Get4Vertex(Int_t i)   {return TLorentzVector(VtxAt(i,0),VtxAt(i,1),VtxAt(i,2),VtxAt(i,3));}
   Int_t               GetVecRecNumber()       const {return fVecRecNumber;}
   Int_t               GetJmu()                const {return fJmu;}
   Int_t               GetJp()                 const {return fJp;}
@@ -375,10 +438,16 @@ public:
   WCSimRootCherenkovDigiHit * RemoveCherenkovDigiHit(WCSimRootCherenkovDigiHit * digit);
   TClonesArray            *GetCherenkovDigiHits() const {return fCherenkovDigiHits;}
 
-  ClassDef(WCSimRootTrigger,3) //WCSimRootEvent structure
+  ClassDef(WCSimRootTrigger,4) //WCSimRootEvent structure
 };
 
 
+// Thread safety: the classes of this library have no mutable static data and
+// do not touch the TProcessID object count, so separate WCSimRootEvent objects
+// can be read concurrently after ROOT::EnableThreadSafety(). Each thread needs
+// its own TFile, TTree and WCSimRootEvent (e.g. one WCSimFlatReader per thread),
+// objects must not be shared between threads. Load the library before
+// starting the threads. See Check_WCSimThreadSafety.C for a consistency check.
 class WCSimRootEvent : public TObject {
 public:
   WCSimRootEvent();
@@ -408,7 +477,7 @@ public:
     int num = tmp->GetHeader()->GetEvtNum();
     ++Current; 
     if ( Current > 9 ) fEventList->Expand(150);
-    fEventList->AddAt(new WCSimRootTrigger(num,Current),Current);
+    fEventList->AddAt(new WCSimRootTrigger(num,Current,&fCapacityHints),Current);
   }
   
   /*  void ReInitialize() { // need to remove all subevents at the end, or they just get added anyway...
@@ -417,6 +486,10 @@ public:
   */
   void Initialize();
 
+  // Capacities of the trigger arrays, set them before Initialize()
+  WCSimRootCapacityHints * GetCapacityHints() { return &fCapacityHints; }
+  const WCSimRootCapacityHints * GetCapacityHints() const { return &fCapacityHints; }
+
   void ReInitialize() { // need to remove all subevents at the end, or they just get added anyway...
     for ( int i = fEventList->GetLast() ; i>=1 ; i--) {
       //      G4cout << "removing element # " << i << "...";
@@ -434,6 +507,7 @@ private:
   //std::vector<WCSimRootTrigger*> fEventList;
   TObjArray* fEventList;
   Int_t Current;                      //!               means transient, not writable to file
+  WCSimRootCapacityHints fCapacityHints;  //! capacities of the arrays of the triggers created by this event
   ClassDef(WCSimRootEvent,1)
 
 };
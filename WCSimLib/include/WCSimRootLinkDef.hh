@@ -14,6 +14,15 @@
 #pragma link C++ class WCSimRootTrack+;
 #pragma link C++ class WCSimRootEventHeader+;
 #pragma link C++ class WCSimRootTrigger+;
+// Class versions up to 3 stored MAX_N_VERTICES (900) modes and vertices per trigger, only the used ones are kept
+#pragma read sourceClass="WCSimRootTrigger" targetClass="WCSimRootTrigger" version="[-3]" \
+  source="Int_t fMode[900]; Int_t fNvtxs; Int_t fVtxsvol[900]; Float_t fVtxs[900][4]" \
+  target="fMode, fVtxsvol, fVtxs" \
+  code="{ Int_t n = onfile.fNvtxs; if (n < 1) n = 1; if (n > 900) n = 900; \
+          fMode.assign(onfile.fMode, onfile.fMode + n); \
+          fVtxsvol.assign(onfile.fVtxsvol, onfile.fVtxsvol + n); \
+          fVtxs.resize(4*n); \
+          for (Int_t i = 0; i < n; i++) for (Int_t j = 0; j < 4; j++) fVtxs[4*i+j] = onfile.fVtxs[i][j]; }"
 #pragma link C++ class WCSimRootEvent+;
 #pragma link C++ class WCSimRootPi0+;
 #pragma link C++ class WCSimRootGeom+;
@@ -21,6 +30,8 @@
 #pragma link C++ class WCSimPmtInfo+;
 #pragma link C++ class WCSimEnumerations+;
 #pragma link C++ class WCSimRootOptions+;
+#pragma link C++ class WCSimFlatReader-;
+#pragma link C++ class WCSimComparisonRecorder-;
 
 #pragma link C++ struct WCSimDarkNoiseOptions+;
 #pragma link C++ class std::pair<std::string, WCSimDarkNoiseOptions>+;
@@ -2,6 +2,8 @@
 #define WCSimRootTools_h 1
 
 #include <vector>
+#include <map>
+#include <string>
 #include <iostream>
 #include <cstdlib>
 
@@ -14,6 +16,45 @@ template <typename T> bool ComparisonPassedVec(const vector<T> & val1, const vec
 					       const char * callerclass, const char * callerfunc, const char * tag);
 */
 
+// Statistics of the failed comparisons of the CompareAllVariables() functions.
+// While a recorder exists it receives every failed ComparisonPassed/ComparisonPassedVec
+// of the thread that created it, so every thread can compare its own events.
+// A quiet recorder also suppresses the printout of the failed comparisons.
+class WCSimComparisonRecorder {
+public:
+  struct Field {
+    long   n_failed;
+    double max_diff;      // largest absolute difference (vector size differences for "size" fields)
+  };
+
+  WCSimComparisonRecorder(bool quiet = true);
+  ~WCSimComparisonRecorder();
+
+  // Fields are named class::tag, with the indices of the tag removed (e.g. WCSimRootTrack::Dir)
+  void  Record(const char * callerclass, const char * tag, double diff);
+  void  Clear() {fFields.clear(); fNFailed = 0;}
+
+  long  GetNFailed() const {return fNFailed;}
+  bool  IsQuiet()    const {return fQuiet;}
+  const std::map<std::string, Field> & GetFields() const {return fFields;}
+  void  Print() const;
+
+  // Recorder of the calling thread, 0 if there is none
+  static WCSimComparisonRecorder * GetCurrent();
+
+private:
+  WCSimComparisonRecorder(const WCSimComparisonRecorder &);
+  WCSimComparisonRecorder & operator=(const WCSimComparisonRecorder &);
+
+  std::map<std::string, Field> fFields;
+  long                         fNFailed;
+  bool                         fQuiet;
+  WCSimComparisonRecorder    * fPrevious;
+};
+
+// true if a quiet recorder is active in the calling thread
+bool ComparisonQuiet();
+
 bool ComparisonPassed(int val1, int val2, 
 		      const char * callerclass, const char * callerfunc, const char * tag);
 bool ComparisonPassed(long val1, long val2,
@@ -0,0 +1,195 @@
+// Column-wise reader of the WCSim event tree, see WCSimFlatReader.hh
+////////////////////////////////////////////////////////////////////////
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TClonesArray.h"
+#include <iostream>
+
+#include "WCSimFlatReader.hh"
+#include "WCSimRootEvent.hh"
+
+using std::cerr;
+using std::endl;
+
+//_____________________________________________________________________________
+
+WCSimFlatReader::WCSimFlatReader(TTree * tree, const char * branch, Long64_t cache_size)
+{
+  fFile = 0;
+  fTree = tree;
+  Init(branch, cache_size);
+}
+
+//_____________________________________________________________________________
+
+WCSimFlatReader::WCSimFlatReader(const char * filename, const char * branch, Long64_t cache_size)
+{
+  fTree = 0;
+  fFile = TFile::Open(filename, "read");
+  if (fFile && !fFile->IsZombie())
+    fTree = (TTree*) fFile->Get("wcsimT");
+  else
+    cerr << "WCSimFlatReader: could not open " << filename << endl;
+  Init(branch, cache_size);
+}
+
+//_____________________________________________________________________________
+
+void WCSimFlatReader::Init(const char * branch, Long64_t cache_size)
+{
+  fEvent = 0;
+  fCapacityHints = new WCSimRootCapacityHints();
+  fColumns = kDefaultColumns;
+  fUnpacked = 0;
+  fEntry = -1;
+  fDigitBegin.assign(1, 0);
+  fTrackBegin.assign(1, 0);
+  fPhotonBegin.assign(1, 0);
+  fPhotonIdBegin.assign(1, 0);
+
+  if (!fTree || !fTree->GetBranch(branch)) {
+    cerr << "WCSimFlatReader: no branch " << branch << " in the tree" << endl;
+    return;
+  }
+
+  // The triggers are stored in a TObjArray, which ROOT does not split, so the
+  // whole event branch is read. Only this branch is enabled and cached, the
+  // exact name also enables its sub-branches but not e.g. "wcsimrootevent_OD".
+  fTree->SetBranchStatus("*", 0);
+  fTree->SetBranchStatus(branch, 1);
+  if (cache_size > 0) {
+    fTree->SetCacheSize(cache_size);
+    fTree->AddBranchToCache(branch, kTRUE);
+  }
+
+  fEvent = new WCSimRootEvent();
+  TBranch * event_branch = fTree->GetBranch(branch);
+  event_branch->SetAddress(&fEvent);
+  // Force deletion of the triggers of the previous entry to prevent a memory leak
+  event_branch->SetAutoDelete(kTRUE);
+}
+
+//_____________________________________________________________________________
+
+WCSimFlatReader::~WCSimFlatReader()
+{
+  if (fTree && fEvent) fTree->ResetBranchAddresses();
+  delete fEvent;
+  delete fCapacityHints;
+  if (fFile) {
+    fFile->Close();
+    delete fFile;
+  }
+}
+
+//_____________________________________________________________________________
+
+Long64_t WCSimFlatReader::GetEntries() const
+{
+  return fTree ? fTree->GetEntries() : 0;
+}
+
+//_____________________________________________________________________________
+
+bool WCSimFlatReader::GetEntry(Long64_t entry)
+{
+  if (!IsValid()) return false;
+  if (fTree->GetEntry(entry) <= 0 || !fEvent) {
+    cerr << "WCSimFlatReader: could not read entry " << entry << endl;
+    return false;
+  }
+  fEntry = entry;
+  Unpack();
+  return true;
+}
+
+//_____________________________________________________________________________
+
+void WCSimFlatReader::Unpack()
+{
+  // Clear the columns, keeping their capacity
+  fUnpacked = fColumns;
+  fTriggerDate.clear();
+  fTriggerType.clear();
+  fDigitBegin.assign(1, 0);
+  fTrackBegin.assign(1, 0);
+  fPhotonBegin.assign(1, 0);
+  fDigitQ.clear();
+  fDigitT.clear();
+  fDigitTube.clear();
+  fPhotonIdBegin.assign(1, 0);
+  fPhotonIds.clear();
+  fTrackPdg.clear();
+  fTrackFlag.clear();
+  fTrackId.clear();
+  fTrackParentId.clear();
+  fTrackParentType.clear();
+  fTrackE.clear();
+  fTrackTime.clear();
+  fTrackStart.clear();
+  fPhotonTrueTime.clear();
+  fPhotonParentId.clear();
+
+  Int_t n_triggers = fEvent->GetNumberOfEvents();
+  for (Int_t itrigger = 0; itrigger < n_triggers; itrigger++) {
+    WCSimRootTrigger * trigger = fEvent->GetTrigger(itrigger);
+    fCapacityHints->Observe(trigger);
+    fTriggerDate.push_back(trigger->GetHeader()->GetDate());
+    fTriggerType.push_back(trigger->GetTriggerType());
+
+    // digits
+    if (fColumns & kDigits) {
+      bool photon_ids = fColumns & kDigitPhotonIds;
+      TClonesArray * digits = trigger->GetCherenkovDigiHits();
+      Int_t n_slots = trigger->GetNcherenkovdigihits_slots();
+      for (Int_t i = 0; i < n_slots; i++) {
+        WCSimRootCherenkovDigiHit * digit = (WCSimRootCherenkovDigiHit*) digits->At(i);
+        if (!digit) continue;
+        fDigitQ.push_back(digit->GetQ());
+        fDigitT.push_back(digit->GetT());
+        fDigitTube.push_back(digit->GetTubeId());
+        if (photon_ids) {
+          const std::vector<int> & ids = digit->GetPhotonIds();
+          fPhotonIds.insert(fPhotonIds.end(), ids.begin(), ids.end());
+          fPhotonIdBegin.push_back(fPhotonIds.size());
+        }
+      }
+    }
+    fDigitBegin.push_back(fDigitQ.size());
+
+    // tracks
+    if (fColumns & kTracks) {
+      bool start = fColumns & kTrackStart;
+      TClonesArray * tracks = trigger->GetTracks();
+      Int_t n_slots = trigger->GetNtrack_slots();
+      for (Int_t i = 0; i < n_slots; i++) {
+        WCSimRootTrack * track = (WCSimRootTrack*) tracks->At(i);
+        if (!track) continue;
+        fTrackPdg.push_back(track->GetIpnu());
+        fTrackFlag.push_back(track->GetFlag());
+        fTrackId.push_back(track->GetId());
+        fTrackParentId.push_back(track->GetParentId());
+        fTrackParentType.push_back(track->GetParenttype());
+        fTrackE.push_back(track->GetE());
+        fTrackTime.push_back(track->GetTime());
+        if (start)
+          for (int j = 0; j < 3; j++) fTrackStart.push_back(track->GetStart(j));
+      }
+    }
+    fTrackBegin.push_back(fTrackPdg.size());
+
+    // true photons
+    if (fColumns & kPhotons) {
+      TClonesArray * photons = trigger->GetCherenkovHitTimes();
+      Int_t n_photons = photons->GetEntriesFast();
+      for (Int_t i = 0; i < n_photons; i++) {
+        WCSimRootCherenkovHitTime * photon = (WCSimRootCherenkovHitTime*) photons->At(i);
+        fPhotonTrueTime.push_back(photon ? photon->GetTruetime() : 0);
+        fPhotonParentId.push_back(photon ? photon->GetParentID() : -1);
+      }
+    }
+    fPhotonBegin.push_back(fPhotonTrueTime.size());
+  }
+}
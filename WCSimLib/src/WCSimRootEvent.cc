@@ -9,7 +9,6 @@
 #include <iostream>
 #include <typeinfo>
 
-#include <TStopwatch.h>
 #include "WCSimRootEvent.hh"
 #include "WCSimRootTools.hh"
 
@@ -71,37 +70,41 @@ WCSimRootTrigger::WCSimRootTrigger()
   fTriggerInfo.clear();
   
   IsZombie = true;
+
+  fCapacityHints = 0;
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++) fInitialCapacity[i] = 0;
   
 }
 
-WCSimRootTrigger::WCSimRootTrigger(int Number,int Subevt)
+WCSimRootTrigger::WCSimRootTrigger(int Number,int Subevt, WCSimRootCapacityHints * hints)
 {
-  this->Initialize();
+  this->Initialize(hints);
   fEvtHdr.Set(Number,0,0,Subevt);
 }
 
 //copy constructor --> only shallow copy of preallocated objects ??
 
 
-void WCSimRootTrigger::Initialize() //actually allocate memory for things in here
+void WCSimRootTrigger::Initialize(WCSimRootCapacityHints * hints) //actually allocate memory for things in here
 {
   // Create an WCSimRootTrigger object.
-  // When the constructor is invoked for the first time, the class static
-  // variable fgTracks is 0 and the TClonesArray fgTracks is created.
-  // Sim. for the other TClonesArray
-  TStopwatch* mystopw = new TStopwatch();
+  // The initial capacities of the TClonesArrays come from the capacity hints
+  // of the owning event (default capacities without hints).
+  fCapacityHints = hints;
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++)
+    fInitialCapacity[i] = hints ? hints->GetCapacity(i) : WCSimRootCapacityHints::kDefaultCapacity;
 
   // TClonesArray of WCSimRootTracks
-  fTracks = new TClonesArray("WCSimRootTrack", 10000);
+  fTracks = new TClonesArray("WCSimRootTrack", fInitialCapacity[WCSimRootCapacityHints::kTracks]);
   fTracks->BypassStreamer(kFALSE); // use the member Streamer
   fNtrack = 0;
   fNtrack_slots = 0;
 
   // TClonesArray of WCSimRootCherenkovHits
   fCherenkovHits = new TClonesArray("WCSimRootCherenkovHit", 
-				    10000);
+				    fInitialCapacity[WCSimRootCapacityHints::kCherenkovHits]);
   fCherenkovHitTimes = new TClonesArray("WCSimRootCherenkovHitTime", 
-					10000);
+					fInitialCapacity[WCSimRootCapacityHints::kCherenkovHitTimes]);
   fCherenkovHits->BypassStreamer(kFALSE); // use the member Streamer
   fCherenkovHitTimes->BypassStreamer(kFALSE); // use the member Streamer
   fNcherenkovhits = 0;
@@ -109,7 +112,7 @@ void WCSimRootTrigger::Initialize() //actually allocate memory for things in her
 
   // TClonesArray of WCSimRootCherenkovDigiHits
   fCherenkovDigiHits = new TClonesArray("WCSimRootCherenkovDigiHit", 
-				       10000);
+				       fInitialCapacity[WCSimRootCapacityHints::kCherenkovDigiHits]);
   fCherenkovDigiHits->BypassStreamer(kFALSE); // use the member Streamer
   fNcherenkovdigihits = 0;
   fNcherenkovdigihits_slots = 0;
@@ -117,11 +120,6 @@ void WCSimRootTrigger::Initialize() //actually allocate memory for things in her
 
   fTriggerType = kTriggerUndefined;
   fTriggerInfo.clear();
-  
-  //  G4cout << " Time to allocate the TCAs :  Real = " << mystopw->RealTime() 
-  //	    << " ; CPU = " << mystopw->CpuTime() << "\n";
-  delete mystopw;
-  
 
   IsZombie = false; // the memory has been allocated
 }
@@ -133,12 +131,11 @@ WCSimRootTrigger::~WCSimRootTrigger()
   // now we must do a bunch a deleting stuff...
   //Destroys all the TClonesArray.. Let's see if Ren'e Brun is right...
 
-  TStopwatch* mystopw = new TStopwatch();
-
-  mystopw->Start();
-
   if (!IsZombie) {
 
+    Int_t shrink[WCSimRootCapacityHints::kNArrays];
+    ObserveCapacity(shrink);
+
     fTracks->Delete();            
     fCherenkovHits->Delete();      
     fCherenkovHitTimes->Delete();   
@@ -149,13 +146,21 @@ WCSimRootTrigger::~WCSimRootTrigger()
     delete   fCherenkovHitTimes;   
     delete   fCherenkovDigiHits; 
   }
-  mystopw->Stop();
+  //Clear("C");
+}
 
-  //  G4cout << " Time to delete the TCAs :  Real = " << mystopw->RealTime() 
-  //    << " ; CPU = " << mystopw->CpuTime() << "\n";
+//_____________________________________________________________________________
 
-  delete mystopw;
-  //Clear("C");
+void WCSimRootTrigger::ObserveCapacity(Int_t shrink[WCSimRootCapacityHints::kNArrays])
+{
+  // Report the used slots of the arrays to the capacity hints and get the
+  // capacities the arrays should be shrunk to (0: keep)
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++) shrink[i] = 0;
+  if (!fCapacityHints || IsZombie) return;
+  TClonesArray * arrays[WCSimRootCapacityHints::kNArrays] = {fTracks, fCherenkovHits, fCherenkovHitTimes, fCherenkovDigiHits};
+  // the used slots are taken from the arrays, which also works after the counters were reset
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++)
+    shrink[i] = fCapacityHints->Observe(i, arrays[i]->GetLast() + 1, fInitialCapacity[i], arrays[i]->GetSize());
 }
 
 //_____________________________________________________________________________
@@ -169,14 +174,9 @@ WCSimRootTrigger & WCSimRootTrigger::operator=(const WCSimRootTrigger & in)
   //then fill
   fEvtHdr = in.fEvtHdr;
   fNvtxs = in.fNvtxs;
-  for(int i = 0; i < MAX_N_VERTICES; i++) {
-    fVtxsvol[i] = in.fVtxsvol[i];
-    for(int j = 0; j < 4; j++) {
-      fVtxs[i][j] = in.fVtxs[i][j];
-    }//j
-    fMode[i] = in.fMode[i];
-
-  }//i
+  fVtxsvol = in.fVtxsvol;
+  fVtxs = in.fVtxs;
+  fMode = in.fMode;
   fVecRecNumber = in.fVecRecNumber;
   fJmu = in.fJmu;
   fJp = in.fJp;
@@ -197,6 +197,11 @@ WCSimRootTrigger & WCSimRootTrigger::operator=(const WCSimRootTrigger & in)
   fTriggerType = in.fTriggerType;
   fTriggerInfo = in.fTriggerInfo;
   IsZombie = in.IsZombie;
+
+  // the cloned arrays are the starting point of the capacity statistics
+  TClonesArray * arrays[WCSimRootCapacityHints::kNArrays] = {fTracks, fCherenkovHits, fCherenkovHitTimes, fCherenkovDigiHits};
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++)
+    fInitialCapacity[i] = arrays[i] ? arrays[i]->GetSize() : 0;
   return *this;
 }
 
@@ -207,6 +212,11 @@ void WCSimRootTrigger::Clear(Option_t */*option*/)
   // To be filled in 
   // Filled in, by MF, 31/08/06  -> Keep all the alloc'ed memory but reset all
   // the indices to 0 in the TCAs.
+
+  // report the used slots before the arrays and their counters are reset
+  Int_t shrink[WCSimRootCapacityHints::kNArrays];
+  ObserveCapacity(shrink);
+
   fNtrack = 0;
   fNtrack_slots = 0;
 
@@ -220,13 +230,19 @@ void WCSimRootTrigger::Clear(Option_t */*option*/)
   fSumQ = 0;
 
   // remove whatever's in the arrays
-  // but don't deallocate the arrays themselves
-
+  // but don't deallocate the arrays themselves, unless they are much larger
+  // than the capacity hints need
   fTracks->Delete();
   fCherenkovHits->Delete();
   fCherenkovHitTimes->Delete();
   fCherenkovDigiHits->Delete();
 
+  TClonesArray * arrays[WCSimRootCapacityHints::kNArrays] = {fTracks, fCherenkovHits, fCherenkovHitTimes, fCherenkovDigiHits};
+  for (int i = 0; i < WCSimRootCapacityHints::kNArrays; i++) {
+    if (shrink[i] > 0) arrays[i]->Expand(shrink[i]);
+    fInitialCapacity[i] = arrays[i]->GetSize();
+  }
+
   fTriggerType = kTriggerUndefined;
   fTriggerInfo.clear();
 
@@ -237,8 +253,10 @@ void WCSimRootTrigger::Clear(Option_t */*option*/)
 
 void WCSimRootTrigger::Reset(Option_t */*option*/)
 {
-// Static function to reset all static objects for this event
-// To be filled in
+// Static function to reset all static objects for this event.
+// WCSimRootTrigger has no static data members (the TClonesArrays belong to
+// the trigger), so there is nothing to reset and this is safe to call from
+// any thread.
 }
 
 //_____________________________________________________________________________
@@ -587,7 +605,7 @@ WCSimRootEvent & WCSimRootEvent::operator=(const WCSimRootEvent & in)
 void WCSimRootEvent::Initialize()
 {
   fEventList = new TObjArray(10,0); // very rarely more than 10 subevents...
-  fEventList->AddAt(new WCSimRootTrigger(0,0),0);
+  fEventList->AddAt(new WCSimRootTrigger(0,0,&fCapacityHints),0);
   Current = 0;
 }
 
@@ -612,11 +630,100 @@ void WCSimRootEvent::Clear(Option_t* /*o*/)
 
 void WCSimRootEvent::Reset(Option_t* /*o*/)
 {
-  //nothing for now
+  //nothing for now: no static objects, see WCSimRootTrigger::Reset
+}
+
+
+
+
+//_____________________________________________________________________________
+
+WCSimRootCapacityHints::WCSimRootCapacityHints(Int_t capacity, bool adaptive)
+{
+  fMinCapacity = 16;
+  fAdaptive = adaptive;
+  SetCapacity(capacity);
+  ResetStatistics();
 }
 
+void WCSimRootCapacityHints::SetCapacity(Int_t array, Int_t capacity)
+{
+  if (array < 0 || array >= kNArrays) return;
+  fCapacity[array] = (capacity > 0) ? capacity : 1;
+}
 
+void WCSimRootCapacityHints::ResetStatistics()
+{
+  for (int i = 0; i < kNArrays; i++) {
+    fHighWaterMark[i] = 0;
+    fNObserved[i] = 0;
+    fNOverflows[i] = 0;
+    fNShrunk[i] = 0;
+  }
+}
 
+Int_t WCSimRootCapacityHints::Observe(Int_t array, Int_t used, Int_t initial, Int_t allocated)
+{
+  if (array < 0 || array >= kNArrays) return 0;
+  fNObserved[array]++;
+  if (used > initial) fNOverflows[array]++;
+  if (used > fHighWaterMark[array]) fHighWaterMark[array] = used;
+  if (!fAdaptive) return 0;
+
+  // new triggers get the high-water mark plus 25% headroom
+  Int_t target = AdaptiveCapacity(array);
+  fCapacity[array] = target;
+  // only shrink arrays that are more than twice as large as needed, so that the arrays do not oscillate
+  if (allocated > 2*target) {
+    fNShrunk[array]++;
+    return target;
+  }
+  return 0;
+}
+
+void WCSimRootCapacityHints::Observe(const WCSimRootTrigger * trigger)
+{
+  // Triggers read from a file have arrays sized by the streamer, so only the
+  // used slots are recorded. In adaptive mode they set the capacities, e.g. for
+  // the triggers of an event that writes the reprocessed events
+  Int_t used[kNArrays] = {trigger->GetNtrack_slots(), trigger->GetNcherenkovhits(), trigger->GetNcherenkovhittimes(), trigger->GetNcherenkovdigihits_slots()};
+  for (int i = 0; i < kNArrays; i++) {
+    fNObserved[i]++;
+    if (used[i] > fHighWaterMark[i]) fHighWaterMark[i] = used[i];
+    if (fAdaptive) fCapacity[i] = AdaptiveCapacity(i);
+  }
+}
+
+Int_t WCSimRootCapacityHints::AdaptiveCapacity(Int_t array) const
+{
+  // the high-water mark plus 25% headroom
+  Int_t target = fHighWaterMark[array] + fHighWaterMark[array]/4;
+  if (target < fMinCapacity) target = fMinCapacity;
+  return target;
+}
+
+const char * WCSimRootCapacityHints::GetArrayName(Int_t array)
+{
+  switch (array) {
+  case kTracks:            return "Tracks";
+  case kCherenkovHits:     return "CherenkovHits";
+  case kCherenkovHitTimes: return "CherenkovHitTimes";
+  case kCherenkovDigiHits: return "CherenkovDigiHits";
+  default:                 return "Unknown";
+  }
+}
+
+void WCSimRootCapacityHints::Print() const
+{
+  cout << "WCSimRootCapacityHints (" << (fAdaptive ? "adaptive" : "fixed") << ")" << endl;
+  for (int i = 0; i < kNArrays; i++) {
+    cout << "  " << GetArrayName(i) << ": capacity " << fCapacity[i]
+	 << ", high-water mark " << fHighWaterMark[i]
+	 << ", observed " << fNObserved[i]
+	 << ", overflows " << fNOverflows[i]
+	 << ", shrunk " << fNShrunk[i] << endl;
+  }
+}
 
 //
 //COMPARISON OPERATORS
@@ -735,22 +842,10 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
   //
   //Check the totals of the arrays of tracks/hits/hittimes/digits
   //
-  if(this->GetTracks()->GetEntries() != c->GetTracks()->GetEntries()) {
-    cerr << "WCSimRootTrigger::CompareAllVariables() Different number of tracks: " << this->GetTracks()->GetEntries() << ", " << c->GetTracks()->GetEntries() << endl;
-    failed = true;
-  }
-  if(this->GetCherenkovHits()->GetEntries() != c->GetCherenkovHits()->GetEntries()) {
-    cerr << "WCSimRootTrigger::CompareAllVariables() Different number of Cherenkov hits: " << this->GetCherenkovHits()->GetEntries() << ", " << c->GetCherenkovHits()->GetEntries() << endl;
-    failed = true;
-  }
-  if(this->GetCherenkovHitTimes()->GetEntries() != c->GetCherenkovHitTimes()->GetEntries()) {
-    cerr << "WCSimRootTrigger::CompareAllVariables() Different number of Cherenkov hit times: " << this->GetCherenkovHitTimes()->GetEntries() << ", " << c->GetCherenkovHitTimes()->GetEntries() << endl;
-    failed = true;
-  }
-  if(this->GetCherenkovDigiHits()->GetEntries() != c->GetCherenkovDigiHits()->GetEntries()) {
-    cerr << "WCSimRootTrigger::CompareAllVariables() Different number of Cherenkov digi hits: " << this->GetCherenkovDigiHits()->GetEntries() << ", " << c->GetCherenkovDigiHits()->GetEntries() << endl;
-    failed = true;
-  }
+  failed = (!ComparisonPassed(this->GetTracks()->GetEntries(), c->GetTracks()->GetEntries(), typeid(*this).name(), __func__, "Number of tracks")) || failed;
+  failed = (!ComparisonPassed(this->GetCherenkovHits()->GetEntries(), c->GetCherenkovHits()->GetEntries(), typeid(*this).name(), __func__, "Number of Cherenkov hits")) || failed;
+  failed = (!ComparisonPassed(this->GetCherenkovHitTimes()->GetEntries(), c->GetCherenkovHitTimes()->GetEntries(), typeid(*this).name(), __func__, "Number of Cherenkov hit times")) || failed;
+  failed = (!ComparisonPassed(this->GetCherenkovDigiHits()->GetEntries(), c->GetCherenkovDigiHits()->GetEntries(), typeid(*this).name(), __func__, "Number of Cherenkov digi hits")) || failed;
 
   //check tracks
   // this is more complicated because there can be some empty slots for at least one of the TClonesArray
@@ -777,7 +872,7 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
     failed = !(tmp_track_1->CompareAllVariables(tmp_track_2)) || failed;
     ncomp_track++;
   }//ithis ithat
-  if(ncomp_track != fNtrack && ncomp_track != c->GetNtrack()) {
+  if(!ComparisonQuiet() && ncomp_track != fNtrack && ncomp_track != c->GetNtrack()) {
     cerr << "Only compared " << ncomp_track << " tracks. There should be " << TMath::Min(fNtrack, c->GetNtrack()) << " comparisons" << endl;
   }
 
@@ -797,7 +892,7 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
 #ifdef VERBOSE_COMPARISON
 	cout << "Hit Time " << j << endl;
 #endif
-	failed = !((WCSimRootCherenkovHitTime *)this->GetCherenkovHitTimes()->At(i))->CompareAllVariables((WCSimRootCherenkovHitTime *)c->GetCherenkovHitTimes()->At(i)) || failed;
+	failed = !((WCSimRootCherenkovHitTime *)this->GetCherenkovHitTimes()->At(j))->CompareAllVariables((WCSimRootCherenkovHitTime *)c->GetCherenkovHitTimes()->At(j)) || failed;
       }//j (WCSimRootCherenkovHitTime)
     }
   }//i (WCSimRootCherenkovHit)
@@ -829,13 +924,14 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
     failed_digits = !(tmp_digit_1->CompareAllVariables(tmp_digit_2)) || failed_digits;
     ncomp_digi++;
   }//while(true)
-  if(ncomp_digi != fNcherenkovdigihits && ncomp_digi != c->GetNcherenkovdigihits()) {
+  if(!ComparisonQuiet() && ncomp_digi != fNcherenkovdigihits && ncomp_digi != c->GetNcherenkovdigihits()) {
     cerr << "Only compared " << ncomp_digi << " digits. There should be " << TMath::Min(fNcherenkovdigihits, c->GetNcherenkovdigihits()) << " comparisons" << endl;
   }
   if(!deep_comparison)
     failed = failed || failed_digits;
   else if(failed_digits) {
-    cout << "Peforming deep comparison" << endl;
+    if(!ComparisonQuiet())
+      cout << "Peforming deep comparison" << endl;
     // We're running a deep comparison and we have some failed digits.
     // We're therefore going to do the check under the assumption that the order of digits can be different between this and that
     vector<WCSimRootCherenkovDigiHit *> tmpdigis;
@@ -855,7 +951,8 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
       }//ithat
       //we've now got a single digit from this, and all the digits on the same PMT from that
       if(!tmpdigis.size()) {
-	cerr << "No digits on this PMT with ID " << this_pmtid << " found on that" << endl;
+	if(!ComparisonQuiet())
+	  cerr << "No digits on this PMT with ID " << this_pmtid << " found on that" << endl;
 	failed = true;
       }
       bool found = false;
@@ -870,12 +967,12 @@ bool WCSimRootTrigger::CompareAllVariables(const WCSimRootTrigger * c, bool deep
     }//ithis
   }//failed_digits && deep_comparison
 
-  failed = (!ComparisonPassed(fMode[0], c->GetMode(), typeid(*this).name(), __func__, "Mode")) || failed;
+  failed = (!ComparisonPassed(GetMode(), c->GetMode(), typeid(*this).name(), __func__, "Mode")) || failed;
   failed = (!ComparisonPassed(fNvtxs, c->GetNvtxs(), typeid(*this).name(), __func__, "Nvtxs")) || failed;
   for(int ivtx = 0; ivtx < fNvtxs; ivtx++) {
-    failed = (!ComparisonPassed(fVtxsvol[ivtx], c->GetVtxsvol(ivtx), typeid(*this).name(), __func__, TString::Format("Vtxvols[%d]", ivtx))) || failed;
+    failed = (!ComparisonPassed(GetVtxsvol(ivtx), c->GetVtxsvol(ivtx), typeid(*this).name(), __func__, TString::Format("Vtxvols[%d]", ivtx))) || failed;
     for(int i = 0; i < 4; i++) {
-      failed = (!ComparisonPassed(fVtxs[ivtx][i], c->GetVtxs(ivtx, i), typeid(*this).name(), __func__, TString::Format("%s[%d][%d]", "Vtxs", ivtx, i))) || failed;
+      failed = (!ComparisonPassed(VtxAt(ivtx, i), c->VtxAt(ivtx, i), typeid(*this).name(), __func__, TString::Format("%s[%d][%d]", "Vtxs", ivtx, i))) || failed;
     }//i
   }//ivtx
   failed = (!ComparisonPassed(fVecRecNumber, c->GetVecRecNumber(), typeid(*this).name(), __func__, "VecRecNumber")) || failed;
@@ -905,10 +1002,7 @@ bool WCSimRootEvent::CompareAllVariables(const WCSimRootEvent * c, bool deep_com
 {
   bool failed = false;
 
-  if(this->GetNumberOfEvents() != c->GetNumberOfEvents()) {
-    cerr << "WCSimRootEvent::CompareAllVariables() Different number of events: " << this->GetNumberOfEvents() << ", " << c->GetNumberOfEvents() << endl;
-    failed = true;
-  }
+  failed = (!ComparisonPassed(this->GetNumberOfEvents(), c->GetNumberOfEvents(), typeid(*this).name(), __func__, "Number of events")) || failed;
 
   for(int i = 0; i < TMath::Min(this->GetNumberOfEvents(), c->GetNumberOfEvents()); i++) {
     failed = !(this->GetTrigger(i)->CompareAllVariables(c->GetTrigger(i), deep_comparison)) || failed;
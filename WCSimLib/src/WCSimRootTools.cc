@@ -14,6 +14,70 @@ using std::vector;
 #endif
 const double kASmallNum = 1E-6;
 
+// Recorder of every thread, see WCSimComparisonRecorder
+static thread_local WCSimComparisonRecorder * gComparisonRecorder = 0;
+
+//_____________________________________________________________________________
+
+WCSimComparisonRecorder::WCSimComparisonRecorder(bool quiet)
+{
+  fNFailed = 0;
+  fQuiet = quiet;
+  fPrevious = gComparisonRecorder;
+  gComparisonRecorder = this;
+}
+
+WCSimComparisonRecorder::~WCSimComparisonRecorder()
+{
+  if(gComparisonRecorder == this)
+    gComparisonRecorder = fPrevious;
+}
+
+WCSimComparisonRecorder * WCSimComparisonRecorder::GetCurrent()
+{
+  return gComparisonRecorder;
+}
+
+void WCSimComparisonRecorder::Record(const char * callerclass, const char * tag, double diff)
+{
+  // typeid names are mangled with the length of the name in front (e.g. 14WCSimRootTrack)
+  while(*callerclass >= '0' && *callerclass <= '9')
+    callerclass++;
+  std::string name(callerclass);
+  name += "::";
+  bool in_index = false;
+  for(const char * c = tag; *c; c++) {
+    if(*c == '[') in_index = true;
+    else if(*c == ']') in_index = false;
+    else if(!in_index) name += *c;
+  }
+  std::map<std::string, Field>::iterator it = fFields.find(name);
+  if(it == fFields.end())
+    it = fFields.insert(std::make_pair(name, Field{0, 0})).first;
+  it->second.n_failed++;
+  if(TMath::Abs(diff) > it->second.max_diff)
+    it->second.max_diff = TMath::Abs(diff);
+  fNFailed++;
+}
+
+void WCSimComparisonRecorder::Print() const
+{
+  cout << fNFailed << " failed comparisons" << endl;
+  for(std::map<std::string, Field>::const_iterator it = fFields.begin(); it != fFields.end(); ++it)
+    cout << "  " << it->first << ": " << it->second.n_failed << " failed, max difference " << it->second.max_diff << endl;
+}
+
+bool ComparisonQuiet()
+{
+  return gComparisonRecorder && gComparisonRecorder->IsQuiet();
+}
+
+static void RecordFailure(const char * callerclass, const char * tag, double diff)
+{
+  if(gComparisonRecorder)
+    gComparisonRecorder->Record(callerclass, tag, diff);
+}
+
 /*
 template <typename T> bool ComparisonPassed(const T val1, const T val2, const char * callerclass, const char * callerfunc, const char * tag)
 {
@@ -47,7 +111,9 @@ template <typename T> bool ComparisonPassedVec(const vector<T> & val1, const vec
 bool ComparisonPassed(int val1, int val2, const char * callerclass, const char * callerfunc, const char * tag)
 {
   if(val1 - val2) {
-    cerr << "INT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
+    RecordFailure(callerclass, tag, val1 - val2);
+    if(!ComparisonQuiet())
+      cerr << "INT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
     return false;
   }
   else {
@@ -61,7 +127,9 @@ bool ComparisonPassed(int val1, int val2, const char * callerclass, const char *
 bool ComparisonPassed(long val1, long val2, const char * callerclass, const char * callerfunc, const char * tag)
 {
   if(val1 - val2) {
-    cerr << "INT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
+    RecordFailure(callerclass, tag, val1 - val2);
+    if(!ComparisonQuiet())
+      cerr << "INT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
     return false;
   }
   else {
@@ -75,7 +143,9 @@ bool ComparisonPassed(long val1, long val2, const char * callerclass, const char
 bool ComparisonPassed(float val1, float val2, const char * callerclass, const char * callerfunc, const char * tag)
 {
   if(TMath::Abs(val1 - val2) > kASmallNum) {
-    cerr << "FLOAT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
+    RecordFailure(callerclass, tag, val1 - val2);
+    if(!ComparisonQuiet())
+      cerr << "FLOAT" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
     return false;
   }
   else {
@@ -89,7 +159,9 @@ bool ComparisonPassed(float val1, float val2, const char * callerclass, const ch
 bool ComparisonPassed(double val1, double val2, const char * callerclass, const char * callerfunc, const char * tag)
 {
   if(TMath::Abs(val1 - val2) > kASmallNum) {
-    cerr << "DOUBLE" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
+    RecordFailure(callerclass, tag, val1 - val2);
+    if(!ComparisonQuiet())
+      cerr << "DOUBLE" << callerclass << "::" << callerfunc << " " << tag << " not equal: " << val1 << ", " << val2 << " diff " << val1 - val2 << endl;
     return false;
   }
   else {
@@ -104,12 +176,14 @@ bool ComparisonPassedVec(const vector<int> & val1, const vector<int> & val2, con
 {
   bool failed = false;
   if(val1.size() != val2.size()) {
-    cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
+    RecordFailure(callerclass, TString::Format("%s size", tag), double(val1.size()) - double(val2.size()));
+    if(!ComparisonQuiet())
+      cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
     failed = true;
   }
   const int n = TMath::Min(val1.size(), val2.size());
   for(int i = 0; i < n; i++) {
-    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i)));
+    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i))) || failed;
   }
   return !failed;
 }
@@ -118,12 +192,14 @@ bool ComparisonPassedVec(const vector<long> & val1, const vector<long> & val2, c
 {
   bool failed = false;
   if(val1.size() != val2.size()) {
-    cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
+    RecordFailure(callerclass, TString::Format("%s size", tag), double(val1.size()) - double(val2.size()));
+    if(!ComparisonQuiet())
+      cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
     failed = true;
   }
   const int n = TMath::Min(val1.size(), val2.size());
   for(int i = 0; i < n; i++) {
-    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i)));
+    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i))) || failed;
   }
   return !failed;
 }
@@ -132,12 +208,14 @@ bool ComparisonPassedVec(const vector<float> & val1, const vector<float> & val2,
 {
   bool failed = false;
   if(val1.size() != val2.size()) {
-    cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
+    RecordFailure(callerclass, TString::Format("%s size", tag), double(val1.size()) - double(val2.size()));
+    if(!ComparisonQuiet())
+      cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
     failed = true;
   }
   const int n = TMath::Min(val1.size(), val2.size());
   for(int i = 0; i < n; i++) {
-    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i)));
+    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i))) || failed;
   }
   return !failed;
 }
@@ -146,12 +224,14 @@ bool ComparisonPassedVec(const vector<double> & val1, const vector<double> & val
 {
   bool failed = false;
   if(val1.size() != val2.size()) {
-    cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
+    RecordFailure(callerclass, TString::Format("%s size", tag), double(val1.size()) - double(val2.size()));
+    if(!ComparisonQuiet())
+      cerr << callerclass << "::" << callerfunc << " " << tag << " have unequal sizes: " << val1.size() << ", " << val2.size() << endl;
     failed = true;
   }
   const int n = TMath::Min(val1.size(), val2.size());
   for(int i = 0; i < n; i++) {
-    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i)));
+    failed = (!ComparisonPassed(val1[i], val2[i], callerclass, callerfunc, TString::Format("%s[%d]", tag, i))) || failed;
   }
   return !failed;
 }
@@ -0,0 +1,94 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef CSVENCODERCLASS_H
+#define CSVENCODERCLASS_H
+
+#include <string>
+#include <vector>
+#include <charconv>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+// Number formats for the csv cells:
+// DEFAULT:  general notation with the given significant digits; with 6 digits identical to streaming a double through a default iostream
+// FIXED:    fixed notation with a given number of decimals
+// SHORTEST: shortest representation which reads back to the identical value
+enum class csvformat : uint8_t { DEFAULT, FIXED, SHORTEST };
+
+// Formats complete csv rows into a reusable buffer with std::to_chars
+class CsvEncoder {
+
+	public:
+
+	CsvEncoder(csvformat formatin=csvformat::DEFAULT, int precisionin=6) : Format(formatin), Precision(precisionin) {}
+
+	inline void SetFormat(csvformat formatin){Format=formatin;}
+	inline void SetPrecision(int precisionin){Precision=precisionin;}
+	inline csvformat GetFormat(){return Format;}
+	inline int GetPrecision(){return Precision;}
+
+	// Encode one row (comma-separated, terminated by a newline). The returned buffer stays valid until the next call.
+	const std::string& EncodeRow(const double* values, size_t n){ return Encode(values, n); }
+	// float cells are printed like the double they convert to (as read back from a TH2F)
+	const std::string& EncodeRow(const float* values, size_t n){ return Encode(values, n); }
+
+	const std::string& EncodeRow(const std::vector<double>& values){ return EncodeRow(values.data(), values.size()); }
+
+	private:
+
+	template<typename T>
+	const std::string& Encode(const T* values, size_t n){
+		// worst case per cell: sign, digits, decimal point, exponent and the separator
+		int precision = (Precision>0) ? Precision : 0;
+		size_t max_cell = (Format==csvformat::FIXED) ? 320+precision : 32+precision;
+		Row.resize(n*max_cell+1);
+		char* first = &Row[0];
+		char* const begin = first;
+		char* const last = begin+Row.size();
+		for(size_t i_cell=0; i_cell<n; i_cell++){
+			first = EncodeCell(first, last, static_cast<double>(values[i_cell]));
+			if(first==last) Fail(values[i_cell]);
+			if(i_cell+1 != n) *first++ = ',';
+		}
+		*first++ = '\n';
+		Row.resize(first-begin);
+		return Row;
+	}
+
+	inline char* EncodeCell(char* first, char* last, double value){
+		// empty pixels dominate the images, so positive zeros bypass the formatting
+		if(value==0. && !std::signbit(value)){
+			if(Format==csvformat::FIXED && Precision>0){
+				*first++ = '0';
+				*first++ = '.';
+				for(int i=0; i<Precision; i++) *first++ = '0';
+				return first;
+			}
+			*first++ = '0';
+			return first;
+		}
+		std::to_chars_result result;
+		switch(Format){
+			case csvformat::FIXED: result = std::to_chars(first, last, value, std::chars_format::fixed, Precision); break;
+			case csvformat::SHORTEST: result = std::to_chars(first, last, value); break;
+			default: result = std::to_chars(first, last, value, std::chars_format::general, Precision); break;
+		}
+		if(result.ec!=std::errc()) Fail(value);
+		return result.ptr;
+	}
+
+	// The row buffer is sized for the worst case, a cell that does not fit is a bug: never write a truncated row
+	[[noreturn]] void Fail(double value){
+		std::cerr<<"CsvEncoder: could not encode "<<value<<" with precision "<<Precision<<std::endl;
+		throw std::length_error("CsvEncoder: cell does not fit into the row buffer");
+	}
+
+	csvformat Format;
+	int Precision;                  // significant digits (DEFAULT) or decimals (FIXED), ignored for SHORTEST
+	std::string Row;                // reusable row buffer
+
+};
+
+#endif
@@ -0,0 +1,96 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef EVENTINDEXCLASS_H
+#define EVENTINDEXCLASS_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+
+// Per-event metadata of a written image, stored as fixed-width record in the sidecar index
+struct EventMeta {
+	int64_t entry;                   // entry in the wcsimT tree of the source file
+	int64_t mcev;                    // running trigger counter of the imaged trigger (used in the histogram names)
+	float vertex[3];                 // true vertex [m]
+	int32_t n_neutrons;
+	int32_t n_sec_neutrons;
+	int32_t n_positrons;
+	int32_t n_gammas;
+	int32_t n_sec_gammas;
+	int32_t rotation;                // azimuthal augmentation: circular column shift of the PMT-wise image (0: original)
+	int32_t mirrored;                // azimuthal augmentation: 1 if the image was mirrored in phi before the shift
+	int32_t cluster;                 // 0: prompt image, k: k-th delayed cluster of the same entry
+	float time_separation;           // start of this image's time window relative to the prompt window [ns] (0 for the prompt image)
+	float window[2];                 // time window of the image in digit time of its trigger (trigger 0 for delayed clusters) [ns]
+	int32_t trigger;                 // trigger of the entry the image was taken from
+	int32_t n_triggers;              // number of triggers of the entry
+};
+static_assert(sizeof(EventMeta)==80, "EventMeta must not contain padding");
+
+// Binary sidecar index with one record per written event, allowing random access into the csv outputs.
+//
+// Layout (little endian, as written by the host):
+//   char[8]  magic "WCSIDX04"
+//   uint32   number of outputs N
+//   uint32   record size in bytes (80 + 8 + 8*N)
+//   uint32 + chars: source file name, followed by the N output file names
+//   records: EventMeta (80 bytes), uint64 record number (= line number in every csv file),
+//            uint64[N] byte offset of the line in each output
+class EventIndex {
+
+	public:
+
+	EventIndex() : NOutputs(0), NRecords(0) {}
+	~EventIndex(){ Close(); }
+
+	bool Open(std::string index_name, std::string source_name, std::vector<std::string> output_names){
+		File.open(index_name.c_str(), std::ios::binary);
+		if(!File.is_open()){
+			std::cerr<<"EventIndex: could not open index file "<<index_name<<std::endl;
+			return false;
+		}
+		NOutputs = output_names.size();
+		File.write("WCSIDX04",8);
+		uint32_t n_outputs = NOutputs;
+		uint32_t record_size = GetRecordSize();
+		File.write(reinterpret_cast<const char*>(&n_outputs),sizeof(n_outputs));
+		File.write(reinterpret_cast<const char*>(&record_size),sizeof(record_size));
+		WriteString(source_name);
+		for(const std::string& aname : output_names) WriteString(aname);
+		return true;
+	}
+
+	// offsets: byte offset of this event's line in each output (size NOutputs)
+	void Write(const EventMeta& meta, const std::vector<uint64_t>& offsets){
+		if(!File.is_open()) return;
+		File.write(reinterpret_cast<const char*>(&meta),sizeof(EventMeta));
+		uint64_t record = NRecords++;
+		File.write(reinterpret_cast<const char*>(&record),sizeof(record));
+		for(unsigned int i_out=0; i_out<NOutputs; i_out++){
+			uint64_t offset = (i_out<offsets.size()) ? offsets.at(i_out) : 0;
+			File.write(reinterpret_cast<const char*>(&offset),sizeof(offset));
+		}
+	}
+
+	void Flush(){ if(File.is_open()) File.flush(); }
+	void Close(){ if(File.is_open()) File.close(); }
+
+	inline uint32_t GetRecordSize(){ return sizeof(EventMeta)+sizeof(uint64_t)*(1+NOutputs); }
+	inline uint64_t GetNumRecords(){ return NRecords; }
+
+	private:
+
+	void WriteString(const std::string& astring){
+		uint32_t length = astring.size();
+		File.write(reinterpret_cast<const char*>(&length),sizeof(length));
+		File.write(astring.data(),length);
+	}
+
+	std::ofstream File;
+	unsigned int NOutputs;
+	uint64_t NRecords;
+
+};
+
+#endif
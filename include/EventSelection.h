@@ -0,0 +1,242 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef EVENTSELECTIONCLASS_H
+#define EVENTSELECTIONCLASS_H
+
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <cstdint>
+
+#include "TruthSummary.h"
+
+// Fields of the truth summary that selections can cut on
+enum class truthfield : uint8_t { NEUTRONS, SEC_NEUTRONS, ALL_NEUTRONS, POSITRONS, GAMMAS, SEC_GAMMAS, ALL_GAMMAS, NEUTRON_GAMMAS, PRIMARIES, ELECTRONS, MUONS,
+	CHARGED_PIONS, PI0S, PROTONS, KAONS, PRIMARY_ENERGY, LEAD_PDG, LEAD_ENERGY, NEUTRINO_PDG, NEUTRINO_ENERGY, UNKNOWN };
+
+inline truthfield ParseTruthField(std::string name){
+	if(name=="neutrons") return truthfield::NEUTRONS;
+	if(name=="sec_neutrons") return truthfield::SEC_NEUTRONS;
+	if(name=="all_neutrons") return truthfield::ALL_NEUTRONS;
+	if(name=="positrons") return truthfield::POSITRONS;
+	if(name=="gammas") return truthfield::GAMMAS;
+	if(name=="sec_gammas") return truthfield::SEC_GAMMAS;
+	if(name=="all_gammas") return truthfield::ALL_GAMMAS;
+	if(name=="neutron_gammas") return truthfield::NEUTRON_GAMMAS;
+	if(name=="primaries") return truthfield::PRIMARIES;
+	if(name=="electrons") return truthfield::ELECTRONS;
+	if(name=="muons") return truthfield::MUONS;
+	if(name=="charged_pions") return truthfield::CHARGED_PIONS;
+	if(name=="pi0s") return truthfield::PI0S;
+	if(name=="protons") return truthfield::PROTONS;
+	if(name=="kaons") return truthfield::KAONS;
+	if(name=="primary_energy") return truthfield::PRIMARY_ENERGY;
+	if(name=="lead_pdg") return truthfield::LEAD_PDG;
+	if(name=="lead_energy") return truthfield::LEAD_ENERGY;
+	if(name=="neutrino_pdg") return truthfield::NEUTRINO_PDG;
+	if(name=="neutrino_energy") return truthfield::NEUTRINO_ENERGY;
+	return truthfield::UNKNOWN;
+}
+
+inline double GetTruthField(const TruthSummary& truth, truthfield field){
+	switch(field){
+		case truthfield::NEUTRONS: return truth.n_neutrons;
+		case truthfield::SEC_NEUTRONS: return truth.n_sec_neutrons;
+		case truthfield::ALL_NEUTRONS: return truth.n_neutrons+truth.n_sec_neutrons;
+		case truthfield::POSITRONS: return truth.n_positrons;
+		case truthfield::GAMMAS: return truth.n_gammas;
+		case truthfield::SEC_GAMMAS: return truth.n_sec_gammas;
+		case truthfield::ALL_GAMMAS: return truth.n_gammas+truth.n_sec_gammas;
+		case truthfield::NEUTRON_GAMMAS: return truth.n_neutron_gammas;
+		case truthfield::PRIMARIES: return truth.n_primaries;
+		case truthfield::ELECTRONS: return truth.n_primary_electrons;
+		case truthfield::MUONS: return truth.n_primary_muons;
+		case truthfield::CHARGED_PIONS: return truth.n_primary_charged_pions;
+		case truthfield::PI0S: return truth.n_primary_pi0s;
+		case truthfield::PROTONS: return truth.n_primary_protons;
+		case truthfield::KAONS: return truth.n_primary_kaons;
+		case truthfield::PRIMARY_ENERGY: return truth.primary_energy;
+		case truthfield::LEAD_PDG: return truth.lead_pdg;
+		case truthfield::LEAD_ENERGY: return truth.lead_energy;
+		case truthfield::NEUTRINO_PDG: return truth.neutrino_pdg;
+		case truthfield::NEUTRINO_ENERGY: return truth.neutrino_energy;
+		default: return 0.;
+	}
+}
+
+// Named selections of the analysis campaigns. Any other name is compiled as an expression.
+inline std::string SelectionPreset(std::string name){
+	if(name=="DSNB-like") return "all_neutrons >= 1 && (all_gammas >= 1 || positrons >= 1)";
+	if(name=="Atmospheric-NC") return "primaries >= 1 && electrons == 0 && muons == 0";
+	if(name=="Inclusive") return "true";
+	return name;
+}
+
+// Event selection on the truth summary, compiled once per run.
+// Expressions combine comparisons "field op value" (op: < <= > >= == !=) with &&, ||, ! and parentheses, e.g.
+//   all_neutrons >= 1 && (all_gammas >= 1 || positrons >= 1)
+// The expression is compiled into a flat list of comparisons and a postfix program over their results, so that
+// evaluating an event is a loop over the comparisons and a few stack operations.
+class EventSelection {
+
+	public:
+
+	EventSelection() : MaxDepth(0) { Compile("true"); }
+
+	bool Compile(std::string expression){
+		Expression = expression;
+		Comparisons.clear();
+		Program.clear();
+		Text = SelectionPreset(expression);
+		Pos = 0;
+		Error = "";
+		if(!ParseOr()) return Fail();
+		SkipSpaces();
+		if(Pos!=Text.size()){ Error = "unexpected '"+Text.substr(Pos)+"'"; return Fail(); }
+		int depth = 0;
+		MaxDepth = 0;
+		for(const Instruction& instr : Program){
+			if(instr.op==opcode::AND || instr.op==opcode::OR) depth--;
+			else if(instr.op!=opcode::NOT) depth++;
+			if(depth>MaxDepth) MaxDepth = depth;
+		}
+		if(MaxDepth>MaxStack){ Error = "expression too deeply nested"; return Fail(); }
+		return true;
+	}
+
+	bool Pass(const TruthSummary& truth) const {
+		bool results[MaxStack];
+		bool passed[MaxComparisons];
+		int n_comparisons = Comparisons.size();
+		for(int i=0; i<n_comparisons; i++){
+			const Comparison& c = Comparisons[i];
+			double value = GetTruthField(truth, c.field);
+			switch(c.op){
+				case compareop::LT: passed[i] = (value < c.threshold); break;
+				case compareop::LE: passed[i] = (value <= c.threshold); break;
+				case compareop::GT: passed[i] = (value > c.threshold); break;
+				case compareop::GE: passed[i] = (value >= c.threshold); break;
+				case compareop::EQ: passed[i] = (value == c.threshold); break;
+				default: passed[i] = (value != c.threshold); break;
+			}
+		}
+		int top = -1;
+		for(const Instruction& instr : Program){
+			switch(instr.op){
+				case opcode::COMPARE: results[++top] = passed[instr.comparison]; break;
+				case opcode::PUSH_TRUE: results[++top] = true; break;
+				case opcode::PUSH_FALSE: results[++top] = false; break;
+				case opcode::NOT: results[top] = !results[top]; break;
+				case opcode::AND: top--; results[top] = results[top] && results[top+1]; break;
+				case opcode::OR: top--; results[top] = results[top] || results[top+1]; break;
+			}
+		}
+		return top==0 && results[0];
+	}
+
+	inline std::string GetExpression() const {return Expression;}
+	inline std::string GetCompiledExpression() const {return Text;}
+	inline std::string GetError() const {return Error;}
+
+	private:
+
+	enum class compareop : uint8_t { LT, LE, GT, GE, EQ, NE };
+	enum class opcode : uint8_t { COMPARE, PUSH_TRUE, PUSH_FALSE, NOT, AND, OR };
+	struct Comparison { truthfield field; compareop op; double threshold; };
+	struct Instruction { opcode op; int comparison; };
+	static const int MaxStack = 32;
+	static const int MaxComparisons = 64;
+
+	bool Fail(){
+		std::cerr<<"EventSelection: could not compile '"<<Text<<"': "<<Error<<std::endl;
+		Comparisons.clear();
+		Program.clear();
+		return false;
+	}
+
+	void SkipSpaces(){ while(Pos<Text.size() && isspace(Text[Pos])) Pos++; }
+
+	bool Accept(std::string token){
+		SkipSpaces();
+		if(Text.compare(Pos,token.size(),token)!=0) return false;
+		Pos += token.size();
+		return true;
+	}
+
+	bool ParseOr(){
+		if(!ParseAnd()) return false;
+		while(Accept("||")){
+			if(!ParseAnd()) return false;
+			Program.push_back(Instruction{opcode::OR,-1});
+		}
+		return true;
+	}
+
+	bool ParseAnd(){
+		if(!ParseUnary()) return false;
+		while(Accept("&&")){
+			if(!ParseUnary()) return false;
+			Program.push_back(Instruction{opcode::AND,-1});
+		}
+		return true;
+	}
+
+	bool ParseUnary(){
+		if(Accept("!")){
+			if(Text.compare(Pos,1,"=")==0){ Error = "unexpected '!='"; return false; }
+			if(!ParseUnary()) return false;
+			Program.push_back(Instruction{opcode::NOT,-1});
+			return true;
+		}
+		if(Accept("(")){
+			if(!ParseOr()) return false;
+			if(!Accept(")")){ Error = "missing ')'"; return false; }
+			return true;
+		}
+		return ParseComparison();
+	}
+
+	bool ParseComparison(){
+		SkipSpaces();
+		size_t start = Pos;
+		while(Pos<Text.size() && (isalnum(Text[Pos]) || Text[Pos]=='_')) Pos++;
+		std::string name = Text.substr(start,Pos-start);
+		if(name.empty()){ Error = "expected a field name at '"+Text.substr(start)+"'"; return false; }
+		if(name=="true" || name=="false"){
+			Program.push_back(Instruction{(name=="true") ? opcode::PUSH_TRUE : opcode::PUSH_FALSE,-1});
+			return true;
+		}
+		Comparison c;
+		c.field = ParseTruthField(name);
+		if(c.field==truthfield::UNKNOWN){ Error = "unknown field '"+name+"'"; return false; }
+		if(Accept("<=")) c.op = compareop::LE;
+		else if(Accept(">=")) c.op = compareop::GE;
+		else if(Accept("==")) c.op = compareop::EQ;
+		else if(Accept("!=")) c.op = compareop::NE;
+		else if(Accept("<")) c.op = compareop::LT;
+		else if(Accept(">")) c.op = compareop::GT;
+		else { Error = "expected a comparison after '"+name+"'"; return false; }
+		SkipSpaces();
+		const char* number = Text.c_str()+Pos;
+		char* end = nullptr;
+		c.threshold = strtod(number,&end);
+		if(end==number){ Error = "expected a number after '"+name+"'"; return false; }
+		Pos += end-number;
+		if((int) Comparisons.size()==MaxComparisons){ Error = "too many comparisons"; return false; }
+		Program.push_back(Instruction{opcode::COMPARE,int(Comparisons.size())});
+		Comparisons.push_back(c);
+		return true;
+	}
+
+	std::string Expression;                  // as configured (preset name or expression)
+	std::string Text;                        // compiled expression
+	std::string Error;
+	size_t Pos;
+	int MaxDepth;
+	std::vector<Comparison> Comparisons;
+	std::vector<Instruction> Program;        // postfix program over the comparison results
+
+};
+
+#endif
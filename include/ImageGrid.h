@@ -0,0 +1,44 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef IMAGEGRIDCLASS_H
+#define IMAGEGRIDCLASS_H
+
+// Uniform 2D grid mapping positions to cells with plain arithmetic.
+// Cells are numbered like the global bins of a fixed-bin TH2: bin 0 and nbins+1 of each axis are under-/overflow,
+// so a flat buffer of GetNCells() entries can be copied into a TH2F bin by bin.
+class ImageGrid {
+
+	public:
+
+	ImageGrid() : NX(1), NY(1), Xmin(0.), Xmax(1.), Ymin(0.), Ymax(1.) {}
+	ImageGrid(int nx, double xmin, double xmax, int ny, double ymin, double ymax) : NX(nx), NY(ny), Xmin(xmin), Xmax(xmax), Ymin(ymin), Ymax(ymax) {}
+
+	// same arithmetic as TAxis::FindBin for fixed bins
+	inline int FindBinX(double x) const {
+		if(x<Xmin) return 0;
+		if(!(x<Xmax)) return NX+1;
+		return 1+int(NX*(x-Xmin)/(Xmax-Xmin));
+	}
+	inline int FindBinY(double y) const {
+		if(y<Ymin) return 0;
+		if(!(y<Ymax)) return NY+1;
+		return 1+int(NY*(y-Ymin)/(Ymax-Ymin));
+	}
+	inline int GetBin(int binx, int biny) const { return binx+(NX+2)*biny; }
+	inline int FindBin(double x, double y) const { return GetBin(FindBinX(x),FindBinY(y)); }
+
+	inline int GetNbinsX() const {return NX;}
+	inline int GetNbinsY() const {return NY;}
+	inline int GetNCells() const {return (NX+2)*(NY+2);}
+	inline double GetXmin() const {return Xmin;}
+	inline double GetXmax() const {return Xmax;}
+	inline double GetYmin() const {return Ymin;}
+	inline double GetYmax() const {return Ymax;}
+
+	private:
+
+	int NX, NY;
+	double Xmin, Xmax, Ymin, Ymax;
+
+};
+
+#endif
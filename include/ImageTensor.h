@@ -0,0 +1,110 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef IMAGETENSORCLASS_H
+#define IMAGETENSORCLASS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Channel order of the packed event images (same order as the csv output files)
+enum class imagechannel : uint8_t { CHARGE, TIME, FIRST_TIME, CHARGE_ABS, TIME_ABS, FIRST_TIME_ABS };
+const int NImageChannels = 6;
+
+inline std::string ImageChannelName(int channel){
+	switch(channel){
+		case int(imagechannel::CHARGE): return "charge";
+		case int(imagechannel::TIME): return "time";
+		case int(imagechannel::FIRST_TIME): return "firsttime";
+		case int(imagechannel::CHARGE_ABS): return "charge_abs";
+		case int(imagechannel::TIME_ABS): return "time_abs";
+		case int(imagechannel::FIRST_TIME_ABS): return "firsttime_abs";
+		default: return "unknown";
+	}
+}
+
+// Truth label channels (optional): fraction of the charge of a pixel from photons of each source class
+enum class labelchannel : uint8_t { POSITRON, GAMMA, OTHER };
+const int NLabelChannels = 3;
+
+inline std::string LabelChannelName(int channel){
+	switch(channel){
+		case int(labelchannel::POSITRON): return "label_positron";
+		case int(labelchannel::GAMMA): return "label_gamma";
+		case int(labelchannel::OTHER): return "label_other";
+		default: return "unknown";
+	}
+}
+
+// All channels of one event image in a single contiguous channels x height x width float buffer (row-major, as consumed by the CNN)
+class ImageTensor {
+
+	public:
+
+	ImageTensor() : C(0), H(0), W(0) {}
+	ImageTensor(int c, int h, int w) : C(c), H(h), W(w), Data(size_t(c)*h*w,0.f) {}
+
+	inline float* Channel(int c){return Data.data()+size_t(c)*H*W;}
+	inline const float* Channel(int c) const {return Data.data()+size_t(c)*H*W;}
+	inline float& At(int c, int cell){return Data[size_t(c)*H*W+cell];}
+	inline int GetCell(int row, int col) const {return row*W+col;}
+
+	inline int GetNChannels() const {return C;}
+	inline int GetHeight() const {return H;}
+	inline int GetWidth() const {return W;}
+	inline size_t GetPlaneSize() const {return size_t(H)*W;}
+	inline size_t GetSize() const {return Data.size();}
+	inline float* GetData(){return Data.data();}
+	inline const float* GetData() const {return Data.data();}
+
+	void Zero(){ std::fill(Data.begin(),Data.end(),0.f); }
+	// change the shape and zero all cells, keeping the allocated buffer
+	void Reshape(int c, int h, int w){ C=c; H=h; W=w; Data.assign(size_t(c)*h*w,0.f); }
+
+	private:
+
+	int C, H, W;
+	std::vector<float> Data;
+
+};
+
+// Downsample an image by an integer factor (the last row/column of cells may cover fewer pixels).
+// Charges are summed, first times take the minimum over the pixels with charge and mean times are weighted with the absolute charge.
+inline void PoolImage(const ImageTensor& src, int factor, ImageTensor& dst){
+	int height = (src.GetHeight()+factor-1)/factor;
+	int width = (src.GetWidth()+factor-1)/factor;
+	dst.Reshape(src.GetNChannels(),height,width);
+	if(src.GetNChannels()!=NImageChannels) return;
+	const float* charge = src.Channel(int(imagechannel::CHARGE));
+	const float* charge_abs = src.Channel(int(imagechannel::CHARGE_ABS));
+	const float* time = src.Channel(int(imagechannel::TIME));
+	const float* time_abs = src.Channel(int(imagechannel::TIME_ABS));
+	const float* first = src.Channel(int(imagechannel::FIRST_TIME));
+	const float* first_abs = src.Channel(int(imagechannel::FIRST_TIME_ABS));
+	std::vector<double> weight(size_t(height)*width,0.), qtime(size_t(height)*width,0.), qtime_abs(size_t(height)*width,0.);
+	std::vector<char> occupied(size_t(height)*width,0);
+	for(int row=0; row<src.GetHeight(); row++){
+		for(int col=0; col<src.GetWidth(); col++){
+			int cell = src.GetCell(row,col);
+			int pooled = dst.GetCell(row/factor,col/factor);
+			dst.At(int(imagechannel::CHARGE),pooled) += charge[cell];
+			dst.At(int(imagechannel::CHARGE_ABS),pooled) += charge_abs[cell];
+			if(!(charge_abs[cell]>0.f)) continue;
+			weight[pooled] += charge_abs[cell];
+			qtime[pooled] += double(charge_abs[cell])*time[cell];
+			qtime_abs[pooled] += double(charge_abs[cell])*time_abs[cell];
+			float& pooled_first = dst.At(int(imagechannel::FIRST_TIME),pooled);
+			float& pooled_first_abs = dst.At(int(imagechannel::FIRST_TIME_ABS),pooled);
+			if(!occupied[pooled] || first[cell]<pooled_first) pooled_first = first[cell];
+			if(!occupied[pooled] || first_abs[cell]<pooled_first_abs) pooled_first_abs = first_abs[cell];
+			occupied[pooled] = 1;
+		}
+	}
+	for(size_t pooled=0; pooled<weight.size(); pooled++){
+		if(weight[pooled]<=0.) continue;
+		dst.At(int(imagechannel::TIME),pooled) = qtime[pooled]/weight[pooled];
+		dst.At(int(imagechannel::TIME_ABS),pooled) = qtime_abs[pooled]/weight[pooled];
+	}
+}
+
+#endif
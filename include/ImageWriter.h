@@ -0,0 +1,205 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef IMAGEWRITERCLASS_H
+#define IMAGEWRITERCLASS_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "TFile.h"
+#include "TObject.h"
+
+#include "CsvEncoder.h"
+#include "EventIndex.h"
+#include "ImageTensor.h"
+
+// Finished event image as handed over from the event loop to the writer stage.
+// Buffers are recycled by the writer, so the vectors keep their capacity between events.
+struct EventImage {
+	std::vector<ImageTensor> tensors;            // resolution levels of the image (full resolution first), every channel of every level is one row in its own csv file
+	ImageTensor movie;                           // time-sliced charge (slices x height x width), written as one row to the csv file after the levels; empty if not used
+	ImageTensor labels;                          // truth label fractions (full resolution only), every channel is one row in its own csv file after the movie; empty if not used
+	std::vector<TObject*> root_objects;          // objects to write to the root file, owned by the writer once pushed
+	EventMeta meta;                              // record for the sidecar index
+};
+
+// Writer stage running on its own thread: consumes finished event images from a bounded queue,
+// batches the csv rows in memory and only flushes the files at checkpoints and at the end.
+// Optionally the packed tensors are also appended to a raw float32 file, one fixed-size CHW block per event and level.
+class ImageWriter {
+
+	public:
+
+	ImageWriter(std::vector<std::string> csv_names, TFile* rootfile, int queue_size=2, int checkpoint=0, size_t batch_bytes=(1<<20), CsvEncoder encoder=CsvEncoder())
+	: RootFile(rootfile), QueueSize(queue_size), Checkpoint(checkpoint), BatchBytes(batch_bytes), NWritten(0), Closed(false), Encoder(encoder) {
+		if(QueueSize<1) QueueSize=1;
+		for(unsigned int i_file=0; i_file<csv_names.size(); i_file++){
+			OutFiles.emplace_back(new std::ofstream(csv_names.at(i_file).c_str()));
+			Buffers.emplace_back();
+			Buffers.back().reserve(BatchBytes);
+		}
+		BytesFlushed.assign(csv_names.size(),0);
+		Offsets.assign(csv_names.size(),0);
+		Worker = std::thread(&ImageWriter::Run, this);
+	}
+
+	~ImageWriter(){ Close(); }
+
+	// Optional sidecar index, filled by the writer thread with the line offsets of every written event (not owned)
+	void SetIndex(EventIndex* index){ Index=index; }
+
+	// Optional raw tensor output, has to be set before the first image is pushed
+	bool SetTensorFile(std::string tensor_name){
+		TensorFile.open(tensor_name.c_str(), std::ios::binary);
+		if(!TensorFile.is_open()){
+			std::cerr<<"ImageWriter: could not open tensor file "<<tensor_name<<std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Get an empty image buffer to fill (recycled if one is available)
+	EventImage* Acquire(){
+		std::unique_lock<std::mutex> lock(Mutex);
+		if(FreeImages.empty()) return new EventImage();
+		EventImage* image = FreeImages.back();
+		FreeImages.pop_back();
+		return image;
+	}
+
+	// Hand over a finished image to the writer thread; blocks while the queue is full
+	void Push(EventImage* image){
+		std::unique_lock<std::mutex> lock(Mutex);
+		NotFull.wait(lock, [this]{ return (int)Queue.size()<QueueSize; });
+		Queue.push_back(image);
+		NotEmpty.notify_one();
+	}
+
+	// Drain the queue, flush all batched output and stop the writer thread
+	void Close(){
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			if(Closed) return;
+			Closed = true;
+			NotEmpty.notify_one();
+		}
+		if(Worker.joinable()) Worker.join();
+		for(unsigned int i_file=0; i_file<OutFiles.size(); i_file++) OutFiles.at(i_file)->close();
+		for(EventImage* image : FreeImages) delete image;
+		FreeImages.clear();
+	}
+
+	inline long GetNumWritten(){ return NWritten; }
+
+	private:
+
+	void Run(){
+		while(true){
+			EventImage* image = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				NotEmpty.wait(lock, [this]{ return !Queue.empty() || Closed; });
+				if(Queue.empty()) break;
+				image = Queue.front();
+				Queue.pop_front();
+				NotFull.notify_one();
+			}
+			Write(image);
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				FreeImages.push_back(image);
+			}
+		}
+		FlushBuffers();
+		if(RootFile) RootFile->Flush();
+		if(Index) Index->Flush();
+	}
+
+	void Write(EventImage* image){
+		unsigned int i_file = 0;
+		for(const ImageTensor& tensor : image->tensors){
+			for(int i_channel=0; i_channel<tensor.GetNChannels() && i_file<Buffers.size(); i_channel++, i_file++){
+				std::string& buffer = Buffers.at(i_file);
+				Offsets.at(i_file) = BytesFlushed.at(i_file)+buffer.size();
+				buffer.append(Encoder.EncodeRow(tensor.Channel(i_channel), tensor.GetPlaneSize()));
+				if(buffer.size() >= BatchBytes) FlushBuffer(i_file);
+			}
+			if(TensorFile.is_open()) TensorFile.write(reinterpret_cast<const char*>(tensor.GetData()), tensor.GetSize()*sizeof(float));
+		}
+		const ImageTensor& movie = image->movie;
+		if(movie.GetSize()>0 && i_file<Buffers.size()){
+			std::string& buffer = Buffers.at(i_file);
+			Offsets.at(i_file) = BytesFlushed.at(i_file)+buffer.size();
+			buffer.append(Encoder.EncodeRow(movie.GetData(), movie.GetSize()));
+			if(buffer.size() >= BatchBytes) FlushBuffer(i_file);
+			if(TensorFile.is_open()) TensorFile.write(reinterpret_cast<const char*>(movie.GetData()), movie.GetSize()*sizeof(float));
+			i_file++;
+		}
+		const ImageTensor& labels = image->labels;
+		if(labels.GetSize()>0){
+			for(int i_channel=0; i_channel<labels.GetNChannels() && i_file<Buffers.size(); i_channel++, i_file++){
+				std::string& buffer = Buffers.at(i_file);
+				Offsets.at(i_file) = BytesFlushed.at(i_file)+buffer.size();
+				buffer.append(Encoder.EncodeRow(labels.Channel(i_channel), labels.GetPlaneSize()));
+				if(buffer.size() >= BatchBytes) FlushBuffer(i_file);
+			}
+			if(TensorFile.is_open()) TensorFile.write(reinterpret_cast<const char*>(labels.GetData()), labels.GetSize()*sizeof(float));
+		}
+		if(Index) Index->Write(image->meta, Offsets);
+		for(TObject* obj : image->root_objects){
+			if(RootFile) RootFile->WriteTObject(obj);
+			delete obj;
+		}
+		image->root_objects.clear();
+		NWritten++;
+		if(Checkpoint>0 && NWritten%Checkpoint==0){
+			FlushBuffers();
+			if(RootFile) RootFile->Flush();
+			if(Index) Index->Flush();
+		}
+	}
+
+	void FlushBuffer(unsigned int i_file){
+		std::string& buffer = Buffers.at(i_file);
+		OutFiles.at(i_file)->write(buffer.data(), buffer.size());
+		BytesFlushed.at(i_file) += buffer.size();
+		buffer.clear();
+	}
+
+	void FlushBuffers(){
+		for(unsigned int i_file=0; i_file<OutFiles.size(); i_file++){
+			FlushBuffer(i_file);
+			OutFiles.at(i_file)->flush();
+		}
+		if(TensorFile.is_open()) TensorFile.flush();
+	}
+
+	TFile* RootFile;                                       // not owned, closed by the caller after Close()
+	int QueueSize;                                         // max. number of images waiting to be written
+	int Checkpoint;                                        // flush files every N written events (0: only at the end)
+	size_t BatchBytes;                                     // size of the in-memory batch per csv file
+	long NWritten;
+	bool Closed;
+	CsvEncoder Encoder;                                    // only used by the writer thread
+	EventIndex* Index=nullptr;
+
+	std::vector<std::unique_ptr<std::ofstream>> OutFiles;
+	std::ofstream TensorFile;                              // raw float32 tensors (optional)
+	std::vector<std::string> Buffers;
+	std::vector<uint64_t> BytesFlushed;                    // bytes already written to each csv file
+	std::vector<uint64_t> Offsets;                         // line offsets of the event being written
+	std::deque<EventImage*> Queue;
+	std::vector<EventImage*> FreeImages;
+	std::mutex Mutex;
+	std::condition_variable NotEmpty, NotFull;
+	std::thread Worker;
+
+};
+
+#endif
@@ -2,10 +2,12 @@
 #ifndef PARTICLECLASS_H
 #define PARTICLECLASS_H
 
-#include <map>
 #include <utility>
 #include <string>
+#include <cstring>
 #include <iostream>
+#include <algorithm>
+#include <type_traits>
 
 #include "Position.h"
 #include "Direction.h"
@@ -14,6 +16,37 @@ using namespace std;
 // world extent in WCSim is +-600cm in all directions!
 enum class tracktype : uint8_t { STARTONLY, ENDONLY, CONTAINED, UNCONTAINED, UNDEFINED };
 
+// Names of common particles, shared by all particles. Sorted by PDG code for the binary search in PdgName.
+struct PdgNameEntry {
+	int code;
+	const char* name;
+};
+
+static constexpr PdgNameEntry PdgNameTable[] = {
+	{-3122,"anti-lambda"}, {-2212,"anti-proton"}, {-2112,"anti-neutron"}, {-321,"K-"}, {-211,"pi-"},
+	{-16,"anti-nu_tau"}, {-15,"tau+"}, {-14,"anti-nu_mu"}, {-13,"mu+"}, {-12,"anti-nu_e"}, {-11,"e+"},
+	{11,"e-"}, {12,"nu_e"}, {13,"mu-"}, {14,"nu_mu"}, {15,"tau-"}, {16,"nu_tau"},
+	{22,"gamma"}, {111,"pi0"}, {130,"K0L"}, {211,"pi+"}, {221,"eta"}, {310,"K0S"}, {311,"K0"}, {321,"K+"},
+	{2112,"neutron"}, {2212,"proton"}, {3112,"sigma-"}, {3122,"lambda"}, {3212,"sigma0"}, {3222,"sigma+"},
+	{1000010020,"deuteron"}, {1000010030,"triton"}, {1000020030,"He3"}, {1000020040,"alpha"},
+	{1000060120,"C12"}, {1000080160,"O16"}
+};
+
+constexpr bool PdgNameTableSorted(){
+	for(size_t i=1; i<sizeof(PdgNameTable)/sizeof(PdgNameTable[0]); i++){
+		if(!(PdgNameTable[i-1].code < PdgNameTable[i].code)) return false;
+	}
+	return true;
+}
+static_assert(PdgNameTableSorted(), "PdgNameTable must be sorted by PDG code");
+
+// Name of a PDG code, nullptr if it is not in the table
+inline const char* PdgName(int pdgcode){
+	const PdgNameEntry* end = PdgNameTable+sizeof(PdgNameTable)/sizeof(PdgNameTable[0]);
+	const PdgNameEntry* entry = std::lower_bound(PdgNameTable, end, pdgcode, [](const PdgNameEntry& a, int code){ return a.code<code; });
+	return (entry!=end && entry->code==pdgcode) ? entry->name : nullptr;
+}
+
 class Particle {
 	
 	
@@ -62,7 +95,7 @@ class Particle {
 	inline double GetTrackLength(){return trackLength;}
 	inline tracktype GetStartStopType(){return StartStopType;}
 	
-	virtual bool Print() {
+	bool Print() {
 		std::cout<<"ParticlePDG : "<<ParticlePDG<<std::endl;
 		std::cout<<"Particle Name : "<<PdgToString(ParticlePDG)<<std::endl;
 		std::cout<<"startEnergy : "<<startEnergy<<std::endl;
@@ -91,7 +124,8 @@ class Particle {
 	}
 	
 	std::string PdgToString (int pdgcode) const{
-		if(pdgcodetoname.count(pdgcode)!=0) return pdgcodetoname.at(pdgcode);
+		const char* name = PdgName(pdgcode);
+		if(name!=nullptr) return name;
 		else return to_string(pdgcode);
 	}
 	
@@ -106,9 +140,6 @@ class Particle {
 	double stopTime;                 //
 	Direction startDirection;        // for primary particle initial scattering dir is most important.
 	double trackLength;              // meters
-	
-	// convenience member
-	std::map<int,std::string> pdgcodetoname;
 	/*
 	template<class Archive> void serialize(Archive & ar, const unsigned int version){
 		if(serialise){
@@ -133,14 +164,16 @@ class MCParticle : public Particle {
 	public:
 	
 	MCParticle() : Particle(0, 0., 0., Position(), Position(), 0., 0., Direction(), 0.,
-				tracktype::UNCONTAINED), ParticleID(0), ParentPdg(0), ParentID(0), Creator(""), Destroyer(""), StartsInFiducialVolume(false), TrackAngleX(0), TrackAngleY(0), TrackAngleFromBeam(0), EntersTank(false), TankEntryPoint(Position()), ExitsTank(false), TankExitPoint(Position()), TrackLengthInTank(0), EntersMrd(false), MrdEntryPoint(Position()), ExitsMrd(false), MrdExitPoint(Position()), PenetratesMrd(false), TrackLengthInMrd(0), MrdPenetration(0), MrdLayersPenetrated(0), MrdEnergyLoss(0), Flag(0) {}
+				tracktype::UNCONTAINED), ParticleID(0), ParentPdg(0), ParentID(0), Creator(), Destroyer(), StartsInFiducialVolume(false), TrackAngleX(0), TrackAngleY(0), TrackAngleFromBeam(0), EntersTank(false), TankEntryPoint(Position()), ExitsTank(false), TankExitPoint(Position()), TrackLengthInTank(0), EntersMrd(false), MrdEntryPoint(Position()), ExitsMrd(false), MrdExitPoint(Position()), PenetratesMrd(false), TrackLengthInMrd(0), MrdPenetration(0), MrdLayersPenetrated(0), MrdEnergyLoss(0), Flag(0) {}
 	
 	MCParticle(int pdg, double sttE, double stpE, Position sttpos, Position stppos, 
 	  double sttt, double stpt, Direction startdir, double len, tracktype tracktypein,
 	  int partid, int parentpdg, int flagid, int parentid, std::string creator, std::string destroyer) 
 	: Particle(pdg, sttE, stpE, sttpos, stppos, sttt, stpt, startdir, len, tracktypein), 
-	  ParticleID(partid), ParentPdg(parentpdg), StartsInFiducialVolume(false), TrackAngleX(0), TrackAngleY(0), TrackAngleFromBeam(0), EntersTank(false), TankEntryPoint(Position()), ExitsTank(false), TankExitPoint(Position()), TrackLengthInTank(0), EntersMrd(false), MrdEntryPoint(Position()), ExitsMrd(false), MrdExitPoint(Position()), PenetratesMrd(false), TrackLengthInMrd(0), MrdPenetration(0), MrdLayersPenetrated(0), MrdEnergyLoss(0), Flag(flagid), ParentID(parentid), Creator(creator), Destroyer(destroyer)
+	  ParticleID(partid), ParentPdg(parentpdg), StartsInFiducialVolume(false), TrackAngleX(0), TrackAngleY(0), TrackAngleFromBeam(0), EntersTank(false), TankEntryPoint(Position()), ExitsTank(false), TankExitPoint(Position()), TrackLengthInTank(0), EntersMrd(false), MrdEntryPoint(Position()), ExitsMrd(false), MrdExitPoint(Position()), PenetratesMrd(false), TrackLengthInMrd(0), MrdPenetration(0), MrdLayersPenetrated(0), MrdEnergyLoss(0), Flag(flagid), ParentID(parentid)
 	  {
+		SetProcessName(Creator, creator);
+		SetProcessName(Destroyer, destroyer);
 		// override Hit tracktype
 		if(tracktypein!=tracktype::UNDEFINED){
 			StartStopType=tracktypein;
@@ -189,8 +222,8 @@ class MCParticle : public Particle {
         inline void SetParentID(int parentidin){ParentID=parentidin;}
 	inline void SetFlag(int flagidin){Flag=flagidin;}
 	
-	inline void SetCreatorProcess(std::string creatorin){Creator = creatorin;}
-        inline void SetDestroyerProcess(std::string destroyerin){Destroyer = destroyerin;}
+	inline void SetCreatorProcess(std::string creatorin){SetProcessName(Creator, creatorin);}
+        inline void SetDestroyerProcess(std::string destroyerin){SetProcessName(Destroyer, destroyerin);}
 
 	inline void SetStartsInFiducialVolume(bool iStartsInFiducialVolume){StartsInFiducialVolume = iStartsInFiducialVolume;}
 	
@@ -273,13 +306,21 @@ class MCParticle : public Particle {
 	}
 	
 	protected:
+	// process names are stored inline (truncated to ProcessNameLength-1 characters), so that particles are trivially copyable
+	static const int ProcessNameLength = 32;
+	static void SetProcessName(char (&dest)[ProcessNameLength], const std::string& name){
+		size_t length = std::min(name.size(), size_t(ProcessNameLength-1));
+		std::memcpy(dest, name.data(), length);
+		std::memset(dest+length, 0, ProcessNameLength-length);
+	}
+
 	int ParticleID;
 	int ParentPdg;
         int ParentID;
 	int Flag;
 	
-	std::string Creator;
-        std::string Destroyer;
+	char Creator[ProcessNameLength];
+        char Destroyer[ProcessNameLength];
 
 	bool StartsInFiducialVolume;
 	
@@ -306,4 +347,8 @@ class MCParticle : public Particle {
 	
 };
 
+// Particles are copied into and out of the per-event particle vectors, which must not allocate
+static_assert(std::is_trivially_copyable<Particle>::value, "Particle must be trivially copyable");
+static_assert(std::is_trivially_copyable<MCParticle>::value, "MCParticle must be trivially copyable");
+
 #endif
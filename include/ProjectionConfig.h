@@ -0,0 +1,102 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef PROJECTIONCONFIGCLASS_H
+#define PROJECTIONCONFIGCLASS_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+
+// Modes are resolved from their names once when the configuration is read; the projection kernels are templates over them
+enum class datamode : uint8_t { NORMAL, CHARGE_WEIGHTED, UNKNOWN };
+enum class savemode : uint8_t { GEOMETRIC, PMTWISE, UNKNOWN };
+
+inline datamode ParseDataMode(std::string name){
+	if(name=="Normal") return datamode::NORMAL;
+	if(name=="Charge-Weighted") return datamode::CHARGE_WEIGHTED;
+	return datamode::UNKNOWN;
+}
+
+inline savemode ParseSaveMode(std::string name){
+	if(name=="Geometric") return savemode::GEOMETRIC;
+	if(name=="PMT-wise") return savemode::PMTWISE;
+	return savemode::UNKNOWN;
+}
+
+inline std::string DataModeToString(datamode mode){
+	switch(mode){
+		case datamode::NORMAL: return "Normal";
+		case datamode::CHARGE_WEIGHTED: return "Charge-Weighted";
+		default: return "Unknown";
+	}
+}
+
+inline std::string SaveModeToString(savemode mode){
+	switch(mode){
+		case savemode::GEOMETRIC: return "Geometric";
+		case savemode::PMTWISE: return "PMT-wise";
+		default: return "Unknown";
+	}
+}
+
+// One output configuration of the 2D projection. Several configurations can be produced from a single pass over the input file.
+struct ProjectionConfig {
+	std::string Name;               // appended to the output file names ("" = no suffix)
+	datamode DataMode;              // options: Normal / Charge-Weighted
+	savemode SaveMode;              // options: Geometric / PMT-wise
+	int DimensionX;                 // geometric image size (32/64/...)
+	int DimensionY;
+	bool IncludeTopBottom;          // include the endcap PMTs in the PMT-wise images
+};
+
+inline bool CheckProjectionConfig(const ProjectionConfig& config){
+	if(config.DataMode==datamode::UNKNOWN){
+		std::cerr<<"ProjectionConfig "<<config.Name<<": unknown DataMode"<<std::endl;
+		return false;
+	}
+	if(config.SaveMode==savemode::UNKNOWN){
+		std::cerr<<"ProjectionConfig "<<config.Name<<": unknown SaveMode"<<std::endl;
+		return false;
+	}
+	if(config.DimensionX<1 || config.DimensionY<1){
+		std::cerr<<"ProjectionConfig "<<config.Name<<": invalid dimensions "<<config.DimensionX<<"x"<<config.DimensionY<<std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Read the output configurations from a text file, one configuration per line:
+// name  DataMode  SaveMode  dimensionX  dimensionY  includeTopBottom
+// Lines starting with '#' are ignored. A name of "-" means no suffix for the output files.
+inline std::vector<ProjectionConfig> ReadProjectionConfigs(std::string filename){
+	std::vector<ProjectionConfig> configs;
+	std::ifstream config_file(filename.c_str());
+	if(!config_file.is_open()){
+		std::cerr<<"ReadProjectionConfigs: could not open config file "<<filename<<std::endl;
+		return configs;
+	}
+	std::string line;
+	while(std::getline(config_file,line)){
+		if(line.empty() || line.find_first_not_of(" \t")==std::string::npos) continue;
+		if(line.at(line.find_first_not_of(" \t"))=='#') continue;
+		std::stringstream ss(line);
+		ProjectionConfig config;
+		std::string data_mode, save_mode;
+		if(!(ss >> config.Name >> data_mode >> save_mode >> config.DimensionX >> config.DimensionY >> config.IncludeTopBottom)){
+			std::cerr<<"ReadProjectionConfigs: could not parse line '"<<line<<"'"<<std::endl;
+			continue;
+		}
+		if(config.Name=="-") config.Name="";
+		config.DataMode = ParseDataMode(data_mode);
+		config.SaveMode = ParseSaveMode(save_mode);
+		if(config.DataMode==datamode::UNKNOWN) std::cerr<<"ReadProjectionConfigs: unknown DataMode "<<data_mode<<std::endl;
+		if(config.SaveMode==savemode::UNKNOWN) std::cerr<<"ReadProjectionConfigs: unknown SaveMode "<<save_mode<<std::endl;
+		if(!CheckProjectionConfig(config)) continue;
+		configs.push_back(config);
+	}
+	return configs;
+}
+
+#endif
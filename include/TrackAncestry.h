@@ -0,0 +1,130 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef TRACKANCESTRYCLASS_H
+#define TRACKANCESTRYCLASS_H
+
+#include <vector>
+#include <cstdint>
+
+// Species classes tracked along the parent chains
+enum class ancestorclass : uint8_t { NEUTRON, GAMMA, ELECTRON, POSITRON, MUON, PION, PROTON, OTHER };
+
+inline ancestorclass GetAncestorClass(int pdg){
+	if(pdg==-11) return ancestorclass::POSITRON;
+	switch(pdg<0 ? -pdg : pdg){
+		case 2112: return ancestorclass::NEUTRON;
+		case 22: return ancestorclass::GAMMA;
+		case 11: return ancestorclass::ELECTRON;
+		case 13: return ancestorclass::MUON;
+		case 111: case 211: return ancestorclass::PION;
+		case 2212: return ancestorclass::PROTON;
+		default: return ancestorclass::OTHER;
+	}
+}
+
+// Flat ancestry index of the saved tracks of one event.
+// Tracks are added in reading order and get consecutive local indices (the same as in the MCParticle list).
+// Build() resolves the parent of every track and, with path compression, its primary ancestor and the species classes
+// of all its saved ancestors, so that the lookups afterwards are O(1). The buffers are reused between events.
+class TrackAncestry {
+
+	public:
+
+	TrackAncestry() : Built(false) {}
+
+	void Clear(){
+		for(int id : TrackIDs) if(id>=0 && id<(int)IdToIndex.size()) IdToIndex[id] = -1;
+		TrackIDs.clear();
+		ParentIDs.clear();
+		Pdgs.clear();
+		Parents.clear();
+		Primaries.clear();
+		AncestorMasks.clear();
+		Built = false;
+	}
+
+	// returns the local index of the track
+	int AddTrack(int track_id, int parent_id, int pdg){
+		int index = TrackIDs.size();
+		TrackIDs.push_back(track_id);
+		ParentIDs.push_back(parent_id);
+		Pdgs.push_back(pdg);
+		if(track_id>=0){
+			if(track_id>=(int)IdToIndex.size()) IdToIndex.resize(track_id+1,-1);
+			IdToIndex[track_id] = index;
+		}
+		Built = false;
+		return index;
+	}
+
+	// One pass over the tracks. Parents that were not saved end the chain, such tracks are their own primary.
+	void Build(){
+		int n_tracks = TrackIDs.size();
+		Parents.assign(n_tracks,-1);
+		Primaries.assign(n_tracks,-1);
+		AncestorMasks.assign(n_tracks,0);
+		for(int index=0; index<n_tracks; index++){
+			int parent = GetIndex(ParentIDs[index]);
+			Parents[index] = (parent!=index) ? parent : -1;
+		}
+		std::vector<int> path;
+		for(int index=0; index<n_tracks; index++){
+			if(Primaries[index]>=0) continue;
+			// walk up to the first resolved track or the top of the chain (a chain is never longer than the number of tracks)
+			path.clear();
+			int current = index;
+			while(current>=0 && Primaries[current]<0 && (int)path.size()<=n_tracks){
+				path.push_back(current);
+				current = Parents[current];
+			}
+			// resolve the path top down, the top of the chain (or of a cyclic chain) is its own primary
+			for(int i_path=path.size()-1; i_path>=0; i_path--){
+				int track = path[i_path];
+				int parent = Parents[track];
+				if(parent>=0 && Primaries[parent]>=0){
+					Primaries[track] = Primaries[parent];
+					AncestorMasks[track] = AncestorMasks[parent] | ClassBit(Pdgs[parent]);
+				} else Primaries[track] = track;
+			}
+		}
+		Built = true;
+	}
+
+	// local index of a track ID, -1 if the track was not saved
+	inline int GetIndex(int track_id) const {
+		return (track_id>=0 && track_id<(int)IdToIndex.size()) ? IdToIndex[track_id] : -1;
+	}
+	inline int GetNTracks() const {return TrackIDs.size();}
+	inline bool IsBuilt() const {return Built;}
+	inline int GetTrackID(int index) const {return TrackIDs[index];}
+	inline int GetPdg(int index) const {return Pdgs[index];}
+	inline int GetParent(int index) const {return Parents[index];}
+	inline int GetPrimary(int index) const {return Primaries[index];}
+	inline int GetPrimaryPdg(int index) const {return Pdgs[Primaries[index]];}
+	inline bool HasAncestor(int index, ancestorclass cls) const {return AncestorMasks[index] & (1u<<int(cls));}
+	// primary ancestor of a track ID, -1 if the track was not saved
+	inline int GetPrimaryOfTrack(int track_id) const {
+		int index = GetIndex(track_id);
+		return (index>=0) ? Primaries[index] : -1;
+	}
+
+	// number of tracks with the given PDG code that have an ancestor of the given class
+	int CountWithAncestor(int pdg, ancestorclass cls) const {
+		int count = 0;
+		for(unsigned int index=0; index<Pdgs.size(); index++) if(Pdgs[index]==pdg && HasAncestor(index,cls)) count++;
+		return count;
+	}
+
+	private:
+
+	static inline uint8_t ClassBit(int pdg){ return 1u<<int(GetAncestorClass(pdg)); }
+
+	bool Built;
+	std::vector<int> TrackIDs, ParentIDs, Pdgs;
+	std::vector<int> Parents;                // local index of the parent, -1: primary or parent not saved
+	std::vector<int> Primaries;              // local index of the primary ancestor (path compressed)
+	std::vector<uint8_t> AncestorMasks;      // bit per ancestorclass of all saved ancestors
+	std::vector<int> IdToIndex;              // dense track ID -> local index table, -1: not saved
+
+};
+
+#endif
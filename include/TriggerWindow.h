@@ -0,0 +1,122 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef TRIGGERWINDOWCLASS_H
+#define TRIGGERWINDOWCLASS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+
+// Modes of selecting the hits that enter the images:
+// FIXED:   fixed time window [start,end] in digit time
+// OPTIONS: readout window of the NDigits trigger as stored in the WCSim options (trigger offset + pre-/post-trigger window)
+// PEAK:    prompt cluster, i.e. the NDigits window with the most digits, extended by the pre-/post-peak margins
+// Independent of the mode, delayed clusters (e.g. neutron captures) can be searched after the prompt window with FindDelayed
+enum class windowmode : uint8_t { FIXED, OPTIONS, PEAK };
+
+// Selected time window of one event, hits with start < t < end are used
+struct TimeWindow {
+	double start;
+	double end;
+	int n_digits;                    // number of digits inside the window (PEAK mode only, -1 otherwise)
+};
+
+class TriggerWindowFinder {
+
+	public:
+
+	TriggerWindowFinder(windowmode modein=windowmode::FIXED, double startin=800., double endin=1200.)
+	: Mode(modein), FixedStart(startin), FixedEnd(endin), NDigitsWindow(200.), NDigitsThreshold(25), PreTriggerWindow(-400.), PostTriggerWindow(950.), TriggerOffset(950.), PrePeak(50.), PostPeak(150.) {}
+
+	// NDigits trigger settings (as stored in WCSimRootOptions) and the offset of the trigger time in digit time
+	void SetNDigitsOptions(double window, double pre_trigger, double post_trigger, double trigger_offset){
+		NDigitsWindow=window;
+		PreTriggerWindow=pre_trigger;
+		PostTriggerWindow=post_trigger;
+		TriggerOffset=trigger_offset;
+	}
+	// Minimum number of digits inside the NDigits window for a delayed cluster
+	void SetNDigitsThreshold(int threshold){ NDigitsThreshold=threshold; }
+	// Margins added in front of the start and after the end of the peak window
+	void SetPeakMargins(double pre_peak, double post_peak){ PrePeak=pre_peak; PostPeak=post_peak; }
+
+	inline windowmode GetMode(){return Mode;}
+	inline double GetNDigitsWindow(){return NDigitsWindow;}
+	inline int GetNDigitsThreshold(){return NDigitsThreshold;}
+
+	// Nominal window of the FIXED and OPTIONS modes, independent of the event
+	TimeWindow GetNominalWindow(){
+		if(Mode==windowmode::OPTIONS) return TimeWindow{TriggerOffset+PreTriggerWindow, TriggerOffset+PostTriggerWindow, -1};
+		return TimeWindow{FixedStart, FixedEnd, -1};
+	}
+
+	// Window of one event. times: digit times of the event, sorted in place in PEAK mode
+	TimeWindow Find(std::vector<double>& times){
+		if(Mode!=windowmode::PEAK) return GetNominalWindow();
+		std::sort(times.begin(),times.end());
+		TimeWindow peak = FindPeak(times, NDigitsWindow);
+		if(peak.n_digits==0) return GetNominalWindow();
+		peak.start -= PrePeak;
+		peak.end += PostPeak;
+		return peak;
+	}
+
+	// Sliding window of the given width containing the most digits, found with a two-pointer scan over the sorted times.
+	// Returns the window [first digit, first digit + width] of the earliest maximum.
+	static TimeWindow FindPeak(const std::vector<double>& sorted_times, double width){
+		TimeWindow peak{0.,0.,0};
+		size_t first=0;
+		for(size_t last=0; last<sorted_times.size(); last++){
+			while(sorted_times[last]-sorted_times[first] > width) first++;
+			int n_digits = last-first+1;
+			if(n_digits > peak.n_digits){
+				peak.n_digits = n_digits;
+				peak.start = sorted_times[first];
+				peak.end = sorted_times[first]+width;
+			}
+		}
+		return peak;
+	}
+
+	// Delayed clusters in the sorted digit times after the given time (usually the end of the prompt window).
+	// A cluster starts where the NDigits window first reaches the threshold; its window is the NDigits window with the most
+	// digits starting within one window width of that point, extended by the peak margins. The search continues after the
+	// end of the cluster, so every digit is part of at most one cluster.
+	std::vector<TimeWindow> FindDelayed(const std::vector<double>& sorted_times, double after){
+		std::vector<TimeWindow> clusters;
+		size_t n_times = sorted_times.size();
+		size_t first = std::upper_bound(sorted_times.begin(),sorted_times.end(),after)-sorted_times.begin();
+		size_t last = first;
+		while(first<n_times){
+			if(last<first) last=first;
+			while(last+1<n_times && sorted_times[last+1]-sorted_times[first] <= NDigitsWindow) last++;
+			if(int(last-first+1) < NDigitsThreshold){ first++; continue; }
+			TimeWindow cluster{sorted_times[first], sorted_times[first]+NDigitsWindow, int(last-first+1)};
+			double latest_start = sorted_times[first]+NDigitsWindow;
+			for(size_t start=first+1; start<n_times && sorted_times[start]<=latest_start; start++){
+				while(last+1<n_times && sorted_times[last+1]-sorted_times[start] <= NDigitsWindow) last++;
+				int n_digits = last-start+1;
+				if(n_digits > cluster.n_digits) cluster = TimeWindow{sorted_times[start], sorted_times[start]+NDigitsWindow, n_digits};
+			}
+			cluster.start -= PrePeak;
+			cluster.end += PostPeak;
+			clusters.push_back(cluster);
+			first = std::upper_bound(sorted_times.begin()+first,sorted_times.end(),cluster.end)-sorted_times.begin();
+		}
+		return clusters;
+	}
+
+	private:
+
+	windowmode Mode;
+	double FixedStart, FixedEnd;                           // FIXED window [ns]
+	double NDigitsWindow;                                  // width of the NDigits sliding window [ns]
+	int NDigitsThreshold;                                  // minimum number of digits of a delayed cluster
+	double PreTriggerWindow, PostTriggerWindow;            // readout window relative to the trigger [ns]
+	double TriggerOffset;                                  // trigger time in digit time [ns]
+	double PrePeak, PostPeak;                              // PEAK margins [ns]
+
+};
+
+#endif
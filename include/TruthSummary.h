@@ -0,0 +1,104 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef TRUTHSUMMARYCLASS_H
+#define TRUTHSUMMARYCLASS_H
+
+#include <iostream>
+
+#include "Position.h"
+
+// Per-event truth needed for the selection and the index, accumulated track by track while the tracks are read.
+// Primary particles are tracks without parent (parent type 0), as in the MCParticle list.
+struct TruthSummary {
+
+	int n_tracks;                    // tracks passed to AddTrack
+	int n_primaries;
+	double low_energy_cut;           // upper energy limit of the counted gammas and positrons [MeV], kept by Clear
+	// IBD-like particle counts (gammas and positrons below the low energy cut)
+	int n_neutrons;                  // primary neutrons
+	int n_sec_neutrons;
+	int n_positrons;                 // primary positrons
+	int n_gammas;                    // primary gammas
+	int n_sec_gammas;
+	int n_neutron_gammas;            // saved gammas of any energy with a neutron among their ancestors (e.g. capture gammas), set from the ancestry index
+	// primary particles by species
+	int n_primary_electrons;         // e-/e+ of any energy
+	int n_primary_muons;
+	int n_primary_charged_pions;
+	int n_primary_pi0s;
+	int n_primary_protons;
+	int n_primary_kaons;
+	// primary vertex: start of the first primary track [m]
+	bool has_primary;
+	Position vertex;
+	// energies [MeV]
+	double primary_energy;           // sum of the start energies of the primaries (without the neutrino)
+	int lead_pdg;                    // most energetic primary (without the neutrino)
+	double lead_energy;
+	int neutrino_pdg;                // incoming neutrino (track flag -1), 0 if there is none
+	double neutrino_energy;
+
+	TruthSummary(double low_energy_cutin=100.) : low_energy_cut(low_energy_cutin) { Clear(); }
+
+	void Clear(){
+		n_tracks = n_primaries = 0;
+		n_neutrons = n_sec_neutrons = n_positrons = n_gammas = n_sec_gammas = n_neutron_gammas = 0;
+		n_primary_electrons = n_primary_muons = n_primary_charged_pions = n_primary_pi0s = n_primary_protons = n_primary_kaons = 0;
+		has_primary = false;
+		vertex = Position(9999999.,9999999.,9999999.);
+		primary_energy = 0.;
+		lead_pdg = 0;
+		lead_energy = 0.;
+		neutrino_pdg = 0;
+		neutrino_energy = 0.;
+	}
+
+	// pdg: track PDG code, parent_type: PDG code of the parent (0 for primaries), energy: start energy [MeV],
+	// start: start position [m], flag: WCSim track flag (-1 incoming neutrino, 0 normal particle)
+	void AddTrack(int pdg, int parent_type, double energy, const Position& start, int flag){
+		n_tracks++;
+		if(parent_type!=0){
+			if(pdg==22 && energy<low_energy_cut) n_sec_gammas++;
+			if(pdg==2112) n_sec_neutrons++;
+			return;
+		}
+		n_primaries++;
+		if(!has_primary){                       // primary particles will have all the same vertex
+			vertex = start;
+			has_primary = true;
+		}
+		if(pdg==2112) n_neutrons++;
+		if(pdg==-11 && energy<low_energy_cut) n_positrons++;
+		if(pdg==22 && energy<low_energy_cut) n_gammas++;
+		if(flag==-1){
+			neutrino_pdg = pdg;
+			neutrino_energy = energy;
+			return;
+		}
+		switch(pdg<0 ? -pdg : pdg){
+			case 11: n_primary_electrons++; break;
+			case 13: n_primary_muons++; break;
+			case 211: n_primary_charged_pions++; break;
+			case 111: n_primary_pi0s++; break;
+			case 2212: n_primary_protons++; break;
+			case 321: case 130: case 310: case 311: n_primary_kaons++; break;
+			default: break;
+		}
+		primary_energy += energy;
+		if(energy>lead_energy){
+			lead_energy = energy;
+			lead_pdg = pdg;
+		}
+	}
+
+	void Print() const {
+		std::cout<<"Tracks : "<<n_tracks<<", primaries : "<<n_primaries<<std::endl;
+		std::cout<<"Neutrino : "<<neutrino_pdg<<", energy : "<<neutrino_energy<<std::endl;
+		std::cout<<"Vertex : "; vertex.Print(true);
+		std::cout<<"Primary energy : "<<primary_energy<<", leading particle : "<<lead_pdg<<" ("<<lead_energy<<" MeV)"<<std::endl;
+		std::cout<<"Primary e/mu/pi+-/pi0/p/K : "<<n_primary_electrons<<"/"<<n_primary_muons<<"/"<<n_primary_charged_pions<<"/"<<n_primary_pi0s<<"/"<<n_primary_protons<<"/"<<n_primary_kaons<<std::endl;
+		std::cout<<"neutron count: "<<n_neutrons<<", secondary neutron count: "<<n_sec_neutrons<<", gamma count: "<<n_gammas<<", secondary gamma count: "<<n_sec_gammas<<", gammas from neutrons: "<<n_neutron_gammas<<", positron count: "<<n_positrons<<std::endl;
+	}
+
+};
+
+#endif